@@ -0,0 +1,387 @@
+// bench.c
+// Host-performance benchmark: synthetic workload generator plus timing of the
+// parser, instruction_decode, has_data_hazard and the full pipeline loop.
+//
+// Build from the repository root (pipelineRun.c without its main):
+//   gcc -O2 -pthread -DPIPELINE_NO_MAIN -I. -o bench.exe bench/bench.c funcs.c memory.c parser.c
+//       register.c pipelineRun.c functional.c sampling.c checkpoint.c trace.c memo.c multicore.c
+//       schedule.c superscalar.c ooo.c storebuffer.c memprofile.c hooks.c watch.c -lm
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include "registers.h"
+#include "memory.h"
+#include "funcs.h"
+#include "parser.h"
+#include "pipelineRun.h"
+
+#define LINE_LENGTH 48
+#define MIN_SECONDS 0.25 // Each measurement repeats until it has run at least this long
+#define TRIALS 3 // Best of several trials, to filter out host noise
+#define DEFAULT_RESULTS "bench_results.csv"
+#define DEFAULT_THRESHOLD 10.0 // Percent slowdown reported as a regression
+
+typedef struct {
+    const char *name;
+    double raw_density; // Chance a source operand is the previous instruction's destination
+    double branch_rate; // Chance a loop-body instruction is a forward JEQ
+    double taken_rate;  // Chance such a JEQ is taken
+    double mem_rate;    // Chance a loop-body instruction is a MOVR/MOVM
+    double store_share; // Fraction of memory instructions that are MOVM
+    int loop_length;    // Instructions in each loop body
+    int program_size;   // Static instruction count to aim for
+    int iterations;     // Trips around each loop
+    uint32_t seed;
+} Workload;
+
+typedef struct {
+    double parse_per_sec;
+    double decode_per_sec;
+    double hazard_per_sec;
+    double cycles_per_sec;
+    double instructions_per_sec;
+} BenchResult;
+
+static const Workload presets[] = {
+    {"alu",       0.10, 0.00, 0.00, 0.00, 0.0, 32, 400, 100, 1},
+    {"raw-chain", 0.90, 0.00, 0.00, 0.00, 0.0, 32, 400, 100, 2},
+    {"branchy",   0.30, 0.25, 0.50, 0.00, 0.0, 16, 400, 100, 3},
+    {"memory",    0.30, 0.05, 0.50, 0.50, 0.5, 16, 400, 100, 4},
+};
+
+static char program_lines[MAX_INSTRUCTIONS][LINE_LENGTH];
+static uint32_t program_words[MAX_INSTRUCTIONS];
+static volatile uint32_t sink; // Keeps measured work from being optimised away
+
+static uint32_t rng_state;
+
+static uint32_t next_random(void) {
+    // xorshift32: deterministic for a given seed on every host
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static bool chance(double p) {
+    return (next_random() % 10000) < (uint32_t)(p * 10000.0);
+}
+
+// R1-R4 hold the loop counter, constant 1, trip count and data base address
+static int random_register(void) {
+    return 5 + (int)(next_random() % 26);
+}
+
+static int source_register(double raw_density, int last_dest) {
+    return (last_dest != 0 && chance(raw_density)) ? last_dest : random_register();
+}
+
+// Emit a loop-structured program; returns the number of lines written
+static int generate_program(const Workload *w) {
+    static const char *alu_ops[] = {"ADD", "SUB", "MUL", "AND"};
+    int n = 0;
+    int last_dest = 0;
+    int loops = (w->program_size - 4) / (w->loop_length + 4);
+    if (loops < 1) loops = 1;
+    rng_state = w->seed ? w->seed : 1;
+
+    snprintf(program_lines[n++], LINE_LENGTH, "MOVI R2 1");
+    snprintf(program_lines[n++], LINE_LENGTH, "MOVI R3 %d", w->iterations);
+    snprintf(program_lines[n++], LINE_LENGTH, "MOVI R4 %d", MEMORY_SIZE / 2);
+
+    for (int loop = 0; loop < loops && n + w->loop_length + 5 < MAX_INSTRUCTIONS; loop++) {
+        snprintf(program_lines[n++], LINE_LENGTH, "MOVI R1 0");
+        int body_start = n;
+        for (int i = 0; i < w->loop_length; i++) {
+            char *line = program_lines[n++];
+            bool last = i == w->loop_length - 1;
+            if (!last && chance(w->branch_rate)) {
+                // JEQ R0 R0 is always taken, JEQ R2 R0 never (R2 = 1); both skip one instruction
+                snprintf(line, LINE_LENGTH, "JEQ %s R0 2", chance(w->taken_rate) ? "R0" : "R2");
+            } else if (chance(w->mem_rate)) {
+                int offset = (int)(next_random() % 64);
+                if (chance(w->store_share)) {
+                    snprintf(line, LINE_LENGTH, "MOVM R%d R4 %d", source_register(w->raw_density, last_dest), offset);
+                } else {
+                    last_dest = random_register();
+                    snprintf(line, LINE_LENGTH, "MOVR R%d R4 %d", last_dest, offset);
+                }
+            } else {
+                int dest = random_register();
+                int kind = (int)(next_random() % 7);
+                if (kind < 4) {
+                    snprintf(line, LINE_LENGTH, "%s R%d R%d R%d", alu_ops[kind], dest,
+                             source_register(w->raw_density, last_dest), source_register(w->raw_density, last_dest));
+                } else if (kind == 4) {
+                    snprintf(line, LINE_LENGTH, "%s R%d R%d %d", (next_random() & 1) ? "LSL" : "LSR", dest,
+                             source_register(w->raw_density, last_dest), (int)(next_random() % 8));
+                } else if (kind == 5) {
+                    // XORI reads and writes the same register
+                    dest = source_register(w->raw_density, last_dest);
+                    snprintf(line, LINE_LENGTH, "XORI R%d %d", dest, (int)(next_random() % 256));
+                } else {
+                    snprintf(line, LINE_LENGTH, "MOVI R%d %d", dest, (int)(next_random() % 1000));
+                }
+                last_dest = dest;
+            }
+        }
+        snprintf(program_lines[n++], LINE_LENGTH, "ADD R1 R1 R2");
+        snprintf(program_lines[n++], LINE_LENGTH, "JEQ R1 R3 2");
+        snprintf(program_lines[n++], LINE_LENGTH, "JMP %d", body_start);
+    }
+    snprintf(program_lines[n++], LINE_LENGTH, "MOVI R31 1");
+    return n;
+}
+
+static double now_seconds(void) {
+    return (double)clock() / CLOCKS_PER_SEC;
+}
+
+static double bench_parser(int count) {
+    long reps = 0;
+    double start = now_seconds(), elapsed;
+    do {
+        for (int i = 0; i < count; i++) sink += parse_instruction(program_lines[i]);
+        reps++;
+    } while ((elapsed = now_seconds() - start) < MIN_SECONDS);
+    return reps * count / elapsed;
+}
+
+static double bench_decode(int count) {
+    long reps = 0;
+    Instruction instr;
+    double start = now_seconds(), elapsed;
+    do {
+        for (int i = 0; i < count; i++) {
+            instruction_decode(program_words[i], &instr);
+            sink += instr.opcode;
+        }
+        reps++;
+    } while ((elapsed = now_seconds() - start) < MIN_SECONDS);
+    return reps * count / elapsed;
+}
+
+// Check every instruction against its three predecessors sitting in EX, MEM and WB
+static double bench_hazard(int count) {
+    static PipelineStage stages[MAX_INSTRUCTIONS];
+    for (int i = 0; i < count; i++) {
+        memset(&stages[i], 0, sizeof(stages[i]));
+        stages[i].instruction = program_words[i];
+        instruction_decode(program_words[i], &stages[i].decoded);
+        stages[i].active = true;
+    }
+    long reps = 0;
+    double start = now_seconds(), elapsed;
+    do {
+        for (int i = 3; i < count; i++) {
+            sink += has_data_hazard(&stages[i].decoded, &stages[i], &stages[i - 1], &stages[i - 2], &stages[i - 3]);
+        }
+        reps++;
+    } while ((elapsed = now_seconds() - start) < MIN_SECONDS);
+    return count > 3 ? reps * (count - 3) / elapsed : 0.0;
+}
+
+// Fresh simulator state with the generated program loaded, as main() would leave it
+static void reset_simulator(int count) {
+    init_memory();
+    init_registers();
+    memset(instruction_memory, 0, sizeof(instruction_memory));
+    memcpy(instruction_memory, program_words, count * sizeof(uint32_t));
+    // Through memory_write() so the dirty bitmap covers the image, as after a normal load
+    for (int i = 0; i < count; i++) memory_write(i, program_words[i]);
+    memory_delta_reset();
+    total_instructions = count;
+    instructions_fetched = 0;
+    instructions_executed = 0;
+    flush_count = 0;
+    flagwork = true;
+    fetch_enabled = true;
+    reset_pipeline();
+}
+
+static void bench_pipeline(int count, BenchResult *result) {
+    long long cycles = 0;
+    long long committed = 0;
+    double start = now_seconds(), elapsed;
+    do {
+        reset_simulator(count);
+        int cycle = 0;
+        while (!pipeline_cycle(cycle)) cycle++;
+        cycles += cycle + 1;
+        committed += instructions_executed;
+    } while ((elapsed = now_seconds() - start) < MIN_SECONDS);
+    result->cycles_per_sec = cycles / elapsed;
+    result->instructions_per_sec = committed / elapsed;
+}
+
+static void describe_workload(const Workload *w, char *buffer, size_t size) {
+    snprintf(buffer, size, "raw=%.2f br=%.2f tk=%.2f mem=%.2f st=%.2f loop=%d size=%d it=%d seed=%u",
+             w->raw_density, w->branch_rate, w->taken_rate, w->mem_rate, w->store_share,
+             w->loop_length, w->program_size, w->iterations, w->seed);
+}
+
+// Find the most recent stored result for the same workload; returns false if there is none
+static bool load_previous(const char *path, const char *name, const char *params, BenchResult *previous, char *label) {
+    FILE *file = fopen(path, "r");
+    if (!file) return false;
+    char line[512];
+    bool found = false;
+    while (fgets(line, sizeof(line), file)) {
+        char row_label[64], row_name[64], row_params[256];
+        BenchResult row;
+        if (sscanf(line, "%63[^,],%63[^,],%255[^,],%lf,%lf,%lf,%lf,%lf", row_label, row_name, row_params,
+                   &row.parse_per_sec, &row.decode_per_sec, &row.hazard_per_sec,
+                   &row.cycles_per_sec, &row.instructions_per_sec) == 8 &&
+            strcmp(row_name, name) == 0 && strcmp(row_params, params) == 0) {
+            *previous = row;
+            strcpy(label, row_label);
+            found = true;
+        }
+    }
+    fclose(file);
+    return found;
+}
+
+static bool compare_metric(const char *metric, double now, double before, double threshold) {
+    double change = before > 0.0 ? (now - before) / before * 100.0 : 0.0;
+    bool regressed = change < -threshold;
+    printf("  %-22s %+7.1f%%%s\n", metric, change, regressed ? "  <-- REGRESSION" : "");
+    return regressed;
+}
+
+static bool run_workload(const Workload *w, const char *label, const char *results_path,
+                         const char *emit_prefix, double threshold) {
+    int count = generate_program(w);
+    for (int i = 0; i < count; i++) {
+        program_words[i] = parse_instruction(program_lines[i]);
+    }
+
+    if (emit_prefix) {
+        char path[256];
+        snprintf(path, sizeof(path), "%s%s.txt", emit_prefix, w->name);
+        FILE *out = fopen(path, "w");
+        if (out) {
+            for (int i = 0; i < count; i++) fprintf(out, "%s\n", program_lines[i]);
+            fclose(out);
+        } else {
+            perror("Error writing workload");
+        }
+    }
+
+    BenchResult result = {0};
+    for (int trial = 0; trial < TRIALS; trial++) {
+        BenchResult current;
+        current.parse_per_sec = bench_parser(count);
+        current.decode_per_sec = bench_decode(count);
+        current.hazard_per_sec = bench_hazard(count);
+        bench_pipeline(count, &current);
+        if (current.parse_per_sec > result.parse_per_sec) result.parse_per_sec = current.parse_per_sec;
+        if (current.decode_per_sec > result.decode_per_sec) result.decode_per_sec = current.decode_per_sec;
+        if (current.hazard_per_sec > result.hazard_per_sec) result.hazard_per_sec = current.hazard_per_sec;
+        if (current.cycles_per_sec > result.cycles_per_sec) {
+            result.cycles_per_sec = current.cycles_per_sec;
+            result.instructions_per_sec = current.instructions_per_sec;
+        }
+    }
+
+    char params[256];
+    describe_workload(w, params, sizeof(params));
+    printf("\n%s (%d instructions; %s)\n", w->name, count, params);
+    printf("  parser                 %12.0f lines/s\n", result.parse_per_sec);
+    printf("  instruction_decode     %12.0f decodes/s\n", result.decode_per_sec);
+    printf("  has_data_hazard        %12.0f checks/s\n", result.hazard_per_sec);
+    printf("  pipeline loop          %12.0f cycles/s\n", result.cycles_per_sec);
+    printf("  pipeline loop          %12.0f instructions/s\n", result.instructions_per_sec);
+
+    bool regressed = false;
+    BenchResult previous;
+    char previous_label[64];
+    if (load_previous(results_path, w->name, params, &previous, previous_label)) {
+        printf("  vs %s:\n", previous_label);
+        regressed |= compare_metric("parser", result.parse_per_sec, previous.parse_per_sec, threshold);
+        regressed |= compare_metric("instruction_decode", result.decode_per_sec, previous.decode_per_sec, threshold);
+        regressed |= compare_metric("has_data_hazard", result.hazard_per_sec, previous.hazard_per_sec, threshold);
+        regressed |= compare_metric("pipeline cycles/s", result.cycles_per_sec, previous.cycles_per_sec, threshold);
+        regressed |= compare_metric("pipeline instr/s", result.instructions_per_sec, previous.instructions_per_sec, threshold);
+    }
+
+    FILE *file = fopen(results_path, "a");
+    if (!file) {
+        perror("Error opening results file");
+    } else {
+        fprintf(file, "%s,%s,%s,%.0f,%.0f,%.0f,%.0f,%.0f\n", label, w->name, params,
+                result.parse_per_sec, result.decode_per_sec, result.hazard_per_sec,
+                result.cycles_per_sec, result.instructions_per_sec);
+        fclose(file);
+    }
+    return regressed;
+}
+
+static void print_usage(const char *prog) {
+    fprintf(stderr,
+            "Usage: %s [--label NAME] [--results FILE] [--threshold PCT] [--emit PREFIX] [--workload NAME]\n"
+            "          [--raw P] [--branch P] [--taken P] [--mem P] [--stores P]\n"
+            "          [--loop N] [--size N] [--iters N] [--seed N]\n"
+            "Without workload parameters the preset suite is run. Exit status 2 means a regression.\n", prog);
+}
+
+int main(int argc, char *argv[]) {
+    const char *label = "unlabelled";
+    const char *results_path = DEFAULT_RESULTS;
+    const char *emit_prefix = NULL;
+    const char *only = NULL;
+    double threshold = DEFAULT_THRESHOLD;
+    Workload custom = presets[0];
+    bool use_custom = false;
+    custom.name = "custom";
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!value) {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        i++;
+        if (strcmp(arg, "--label") == 0) label = value;
+        else if (strcmp(arg, "--results") == 0) results_path = value;
+        else if (strcmp(arg, "--threshold") == 0) threshold = atof(value);
+        else if (strcmp(arg, "--emit") == 0) emit_prefix = value;
+        else if (strcmp(arg, "--workload") == 0) only = value;
+        else {
+            use_custom = true;
+            if (strcmp(arg, "--raw") == 0) custom.raw_density = atof(value);
+            else if (strcmp(arg, "--branch") == 0) custom.branch_rate = atof(value);
+            else if (strcmp(arg, "--taken") == 0) custom.taken_rate = atof(value);
+            else if (strcmp(arg, "--mem") == 0) custom.mem_rate = atof(value);
+            else if (strcmp(arg, "--stores") == 0) custom.store_share = atof(value);
+            else if (strcmp(arg, "--loop") == 0) custom.loop_length = atoi(value);
+            else if (strcmp(arg, "--size") == 0) custom.program_size = atoi(value);
+            else if (strcmp(arg, "--iters") == 0) custom.iterations = atoi(value);
+            else if (strcmp(arg, "--seed") == 0) custom.seed = (uint32_t)strtoul(value, NULL, 10);
+            else {
+                print_usage(argv[0]);
+                return EXIT_FAILURE;
+            }
+        }
+    }
+    if (custom.loop_length < 1 || custom.iterations < 1 || custom.program_size < 1) {
+        fprintf(stderr, "Bench Error: --loop, --size and --iters must be positive\n");
+        return EXIT_FAILURE;
+    }
+
+    trace_enabled = false;
+    bool regressed = false;
+    if (use_custom) {
+        regressed = run_workload(&custom, label, results_path, emit_prefix, threshold);
+    } else {
+        for (size_t i = 0; i < sizeof(presets) / sizeof(presets[0]); i++) {
+            if (only && strcmp(only, presets[i].name) != 0) continue;
+            regressed |= run_workload(&presets[i], label, results_path, emit_prefix, threshold);
+        }
+    }
+    return regressed ? 2 : EXIT_SUCCESS;
+}
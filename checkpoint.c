@@ -0,0 +1,151 @@
+// checkpoint.c
+// Save/restore of full simulator state
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "registers.h"
+#include "memory.h"
+#include "funcs.h"
+#include "pipelineRun.h"
+#include "checkpoint.h"
+
+#define CHECKPOINT_MAGIC 0x4B43504Eu // "NPCK"
+#define CHECKPOINT_VERSION 3
+
+// Scalar state kept in one block so adding a field only touches this struct
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    int32_t clock_cycle;
+    uint32_t pc;
+    int32_t total_instructions;
+    int32_t instructions_fetched;
+    int32_t instructions_executed;
+    int32_t flush_flag;
+    uint32_t branch_target;
+    uint32_t branch_flush_target;
+    uint32_t branch_flush_pc;
+    uint32_t branch_flush_trace_index;
+    uint32_t final_result;
+    uint8_t pending_flush;
+    uint8_t flagwork;
+    uint8_t fetch_enabled;
+    uint8_t reserved;
+} CheckpointHeader;
+
+// Write `count` words as (start, length, words...) runs of non-zero values, ended by a zero-length run
+static bool write_sparse(FILE *file, const uint32_t *words, uint32_t count) {
+    uint32_t i = 0;
+    while (i < count) {
+        if (words[i] == 0) {
+            i++;
+            continue;
+        }
+        uint32_t start = i;
+        while (i < count && words[i] != 0) i++;
+        uint32_t run[2] = {start, i - start};
+        if (fwrite(run, sizeof(run), 1, file) != 1) return false;
+        if (fwrite(&words[start], sizeof(uint32_t), run[1], file) != run[1]) return false;
+    }
+    uint32_t end[2] = {0, 0};
+    return fwrite(end, sizeof(end), 1, file) == 1;
+}
+
+static bool read_sparse(FILE *file, uint32_t *words, uint32_t count) {
+    memset(words, 0, count * sizeof(uint32_t));
+    for (;;) {
+        uint32_t run[2];
+        if (fread(run, sizeof(run), 1, file) != 1) return false;
+        if (run[1] == 0) return true;
+        if (run[0] >= count || run[1] > count - run[0]) return false;
+        if (fread(&words[run[0]], sizeof(uint32_t), run[1], file) != run[1]) return false;
+    }
+}
+
+int save_checkpoint(const char *path, int clock_cycle) {
+    FILE *file = fopen(path, "wb");
+    if (!file) {
+        perror("Error opening checkpoint file");
+        return -1;
+    }
+
+    CheckpointHeader header = {0};
+    header.magic = CHECKPOINT_MAGIC;
+    header.version = CHECKPOINT_VERSION;
+    header.clock_cycle = clock_cycle;
+    header.pc = PC;
+    header.total_instructions = total_instructions;
+    header.instructions_fetched = instructions_fetched;
+    header.instructions_executed = instructions_executed;
+    header.flush_flag = flush_flag;
+    header.branch_target = branch_target;
+    header.branch_flush_target = branch_flush_target;
+    header.branch_flush_pc = branch_flush_pc;
+    header.branch_flush_trace_index = branch_flush_trace_index;
+    header.final_result = finalResult;
+    header.pending_flush = pending_flush;
+    header.flagwork = flagwork;
+    header.fetch_enabled = fetch_enabled;
+
+    PipelineStage *stages[5] = {&if_stage, &id_stage, &ex_stage, &mem_stage, &wb_stage};
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              fwrite(registers, sizeof(uint32_t), NUM_REGISTERS, file) == NUM_REGISTERS;
+    for (int i = 0; ok && i < 5; i++) {
+        ok = fwrite(stages[i], sizeof(PipelineStage), 1, file) == 1;
+    }
+    ok = ok && write_sparse(file, instruction_memory, MAX_INSTRUCTIONS) &&
+         write_sparse(file, memory, MEMORY_SIZE);
+
+    if (fclose(file) != 0) ok = false;
+    if (!ok) {
+        fprintf(stderr, "Checkpoint Error: failed to write %s\n", path);
+        return -1;
+    }
+    printf("[CHECKPOINT] Saved state at cycle %d (PC %u) to %s\n", clock_cycle, PC, path);
+    return 0;
+}
+
+int load_checkpoint(const char *path, int *clock_cycle) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        perror("Error opening checkpoint file");
+        return -1;
+    }
+
+    CheckpointHeader header;
+    bool ok = fread(&header, sizeof(header), 1, file) == 1 &&
+              header.magic == CHECKPOINT_MAGIC && header.version == CHECKPOINT_VERSION;
+    ok = ok && fread(registers, sizeof(uint32_t), NUM_REGISTERS, file) == NUM_REGISTERS;
+
+    PipelineStage *stages[5] = {&if_stage, &id_stage, &ex_stage, &mem_stage, &wb_stage};
+    for (int i = 0; ok && i < 5; i++) {
+        ok = fread(stages[i], sizeof(PipelineStage), 1, file) == 1;
+    }
+    ok = ok && read_sparse(file, instruction_memory, MAX_INSTRUCTIONS) &&
+         read_sparse(file, memory, MEMORY_SIZE);
+    if (ok) memory_rebuild_dirty();
+    fclose(file);
+
+    if (!ok) {
+        fprintf(stderr, "Checkpoint Error: %s is not a valid checkpoint\n", path);
+        return -1;
+    }
+
+    *clock_cycle = header.clock_cycle;
+    PC = header.pc;
+    total_instructions = header.total_instructions;
+    instructions_fetched = header.instructions_fetched;
+    instructions_executed = header.instructions_executed;
+    flush_flag = header.flush_flag;
+    branch_target = header.branch_target;
+    branch_flush_target = header.branch_flush_target;
+    branch_flush_pc = header.branch_flush_pc;
+    branch_flush_trace_index = header.branch_flush_trace_index;
+    finalResult = header.final_result;
+    pending_flush = header.pending_flush;
+    flagwork = header.flagwork;
+    fetch_enabled = header.fetch_enabled;
+    printf("[CHECKPOINT] Restored state at cycle %d (PC %u) from %s\n", *clock_cycle, PC, path);
+    return 0;
+}
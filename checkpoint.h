@@ -0,0 +1,16 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+// Snapshot of the complete simulator state (registers, PC, memory, instruction
+// memory, the five pipeline stages, flush state and counters) between two cycles.
+// Memory is stored as runs of non-zero words so snapshots stay small.
+
+// Write the current state to `path`; clock_cycle is the next cycle to simulate.
+// Returns 0 on success, -1 on failure.
+int save_checkpoint(const char *path, int clock_cycle);
+
+// Replace the current state with the one stored in `path` and return the cycle
+// to resume from in *clock_cycle. Returns 0 on success, -1 on failure.
+int load_checkpoint(const char *path, int *clock_cycle);
+
+#endif // CHECKPOINT_H
@@ -0,0 +1,9 @@
+#ifndef CORE_LOCAL_H
+#define CORE_LOCAL_H
+
+// State private to one simulated core. In a multicore run every core is
+// simulated on its own host thread, so per-core globals are thread-local;
+// a single-core run simply uses the main thread's copy.
+#define CORE_LOCAL _Thread_local
+
+#endif // CORE_LOCAL_H
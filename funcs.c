@@ -7,32 +7,37 @@
 #include "memory.h"
 # include "funcs.h"
 #include "parser.h"
+#include "multicore.h"
+#include "storebuffer.h"
+#include "hooks.h"
 
 #define FILENAME "program.txt"
 #define MAX_INSTRUCTIONS 1024
 
-extern uint32_t instruction_memory[MAX_INSTRUCTIONS];
-bool flagwork = true;
+extern CORE_LOCAL uint32_t instruction_memory[MAX_INSTRUCTIONS];
+CORE_LOCAL bool flagwork = true;
+bool trace_enabled = true;
 
-uint32_t instruction = 0;
-int flush_flag = 0;
-uint32_t branch_target = 0;
+CORE_LOCAL uint32_t instruction = 0;
+CORE_LOCAL int flush_flag = 0;
+CORE_LOCAL uint32_t branch_target = 0;
 
 // Globals for MOVR flow
-uint32_t finalResult = 0;
+CORE_LOCAL uint32_t finalResult = 0;
 
-extern uint32_t PC;
-extern uint32_t registers[NUM_REGISTERS];
+extern CORE_LOCAL uint32_t PC;
+extern CORE_LOCAL uint32_t registers[NUM_REGISTERS];
 
 
 // Safe register write: R0 is protected
 void safe_register_write(uint8_t reg, uint32_t value, const char* stage) {
     if (reg == 0) {
         registers[0] = 0;
-        printf("%s: Attempted to write to R0 — skipped (R0 remains 0)\n", stage);
+        TRACE("%s: Attempted to write to R0 — skipped (R0 remains 0)\n", stage);
     } else if (reg < NUM_REGISTERS) {
+        HOOK(HOOK_REGISTER_WRITE, .pc = hook_pc, .location = reg, .value = value, .old_value = registers[reg]);
         registers[reg] = value;
-        printf("%s: Wrote %u to R%d\n", stage, value, reg);
+        TRACE("%s: Wrote %u to R%d\n", stage, value, reg);
     } else {
         fprintf(stderr, "%s: Invalid register index R%d\n", stage, reg);
     }
@@ -54,7 +59,8 @@ uint32_t instruction_fetch(uint32_t *memory) {
     }
 
     uint32_t instr = memory[PC];
-    printf("Fetch Stage: Fetched instruction at address %u => 0x%08X\n", PC, instr);
+    HOOK(HOOK_FETCH, .pc = PC, .instruction = instr);
+    TRACE("Fetch Stage: Fetched instruction at address %u => 0x%08X\n", PC, instr);
     return instr;
 
 
@@ -151,9 +157,9 @@ uint32_t execute(Instruction *instr, uint32_t instruction_address) {
             if (registers[instr->r1] == registers[instr->r2]) {
                 flush_flag = 1;
                 branch_target = instruction_address + instr->imm;
-                printf("JEQ: Branch taken. New PC will be %u\n", branch_target);
+                TRACE("JEQ: Branch taken. New PC will be %u\n", branch_target);
             } else {
-                printf("JEQ: Condition false. Continue normally.\n");
+                TRACE("JEQ: Condition false. Continue normally.\n");
             }
             break;
         case 8: // XORI
@@ -167,15 +173,15 @@ uint32_t execute(Instruction *instr, uint32_t instruction_address) {
             break;
         case 11: // JMP
             flush_flag = 1;
-            printf("JMP: Decoded addr = %u\n", instr->addr);
+            TRACE("JMP: Decoded addr = %u\n", instr->addr);
             branch_target = instr->addr;
-            printf("JMP: Jumping to address %u\n", branch_target);
+            TRACE("JMP: Jumping to address %u\n", branch_target);
             break;
         default:
             fprintf(stderr, "Invalid opcode: %d in Execute\n", instr->opcode);
             break;
     }
-    printf("Execute Stage: Opcode %d, Result = %d\n", instr->opcode, result);
+    TRACE("Execute Stage: Opcode %d, Result = %d\n", instr->opcode, result);
     return (uint32_t)result;
 }
 
@@ -189,8 +195,16 @@ void memory_access(uint32_t *memory, Instruction *instr) {
             fprintf(stderr, "MOVM Error: Address %u out of bounds.\n", address);
             exit(EXIT_FAILURE);
         }
-        memory[address] = registers[instr->r1];
-        printf("[MEM] MOVM: Stored value %d from R%d into memory[%u]\n", (int32_t)registers[instr->r1], instr->r1, address);
+        HOOK(HOOK_MEMORY_ACCESS, .pc = hook_pc, .location = address, .value = registers[instr->r1],
+             .old_value = memory[address], .is_store = true);
+        if (multicore_active) {
+            shared_memory_write(address, registers[instr->r1]);
+        } else if (store_buffer_enabled) {
+            store_buffer_push(address, registers[instr->r1]); // Pipeline guarantees a free entry
+        } else {
+            memory_write(address, registers[instr->r1]);
+        }
+        TRACE("[MEM] MOVM: Stored value %d from R%d into memory[%u]\n", (int32_t)registers[instr->r1], instr->r1, address);
     } else if (instr->opcode == 9) { // MOVR (load)
         // Load value from memory at address (registers[r2] + imm) into finalResult
         uint32_t address = registers[instr->r2] + instr->imm;
@@ -198,8 +212,13 @@ void memory_access(uint32_t *memory, Instruction *instr) {
             fprintf(stderr, "MOVR Error: Address %u out of bounds.\n", address);
             exit(EXIT_FAILURE);
         }
-        finalResult = memory[address];
-        printf("[MEM] MOVR: Read value %d from memory[%u]\n", (int32_t)finalResult, address);
+        if (store_buffer_enabled && store_buffer_lookup(address, &finalResult)) {
+            TRACE("[MEM] MOVR: Forwarded value %d for memory[%u] from the store buffer\n", (int32_t)finalResult, address);
+        } else {
+            finalResult = multicore_active ? shared_memory_read(address) : memory[address];
+            TRACE("[MEM] MOVR: Read value %d from memory[%u]\n", (int32_t)finalResult, address);
+        }
+        HOOK(HOOK_MEMORY_ACCESS, .pc = hook_pc, .location = address, .value = finalResult);
     }
 }
 
@@ -208,16 +227,16 @@ void memory_access(uint32_t *memory, Instruction *instr) {
 void write_back(Instruction *instr, uint32_t result) {
     // Write for all R-type (0-5), MOVI (6), XORI (8), MOVR (9)
     if (instr->opcode >= 0 && instr->opcode <= 5) {
-        printf("[WB] R-type: Writing %d to R%d\n", (int32_t)result, instr->r1);
+        TRACE("[WB] R-type: Writing %d to R%d\n", (int32_t)result, instr->r1);
         safe_register_write(instr->r1, result & 0xFFFFFFFF, "Write Back Stage");
     } else if (instr->opcode == 6) {
-        printf("[WB] MOVI: Writing %d to R%d\n", (int32_t)result, instr->r1);
+        TRACE("[WB] MOVI: Writing %d to R%d\n", (int32_t)result, instr->r1);
         safe_register_write(instr->r1, result & 0xFFFFFFFF, "Write Back Stage (MOVI)");
     } else if (instr->opcode == 8) {
-        printf("[WB] XORI: Writing %d to R%d\n", (int32_t)result, instr->r1);
+        TRACE("[WB] XORI: Writing %d to R%d\n", (int32_t)result, instr->r1);
         safe_register_write(instr->r1, result & 0xFFFFFFFF, "Write Back Stage (XORI)");
     } else if (instr->opcode == 9) { // MOVR writes from finalResult
-        printf("[WB] MOVR: Writing %d to R%d\n", (int32_t)finalResult, instr->r1);
+        TRACE("[WB] MOVR: Writing %d to R%d\n", (int32_t)finalResult, instr->r1);
         safe_register_write(instr->r1, finalResult & 0xFFFFFFFF, "Write Back Stage (MOVR)");
     }
     // No write-back for MOVM (10), JEQ (7), JMP (11)
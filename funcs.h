@@ -1,4 +1,10 @@
+#ifndef FUNCS_H
+#define FUNCS_H
+
 #include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "corelocal.h"
 
 // Instruction structure definition
 typedef struct {
@@ -25,10 +31,15 @@ void write_instruction_memory(uint32_t *instruction_array);
 void print_memory(void);
 
 // Global variables
-extern uint32_t instruction;
-extern int flush_flag;
-extern uint32_t branch_target;
+extern CORE_LOCAL uint32_t instruction;
+extern CORE_LOCAL int flush_flag;
+extern CORE_LOCAL uint32_t branch_target;
 extern uint32_t movr_address;
-extern uint32_t finalResult;
-extern bool flagwork;
+extern CORE_LOCAL uint32_t finalResult;
+extern CORE_LOCAL bool flagwork;
+extern bool trace_enabled;
+
+// Per-cycle trace output; turned off for quiet and sampled runs
+#define TRACE(...) do { if (trace_enabled) printf(__VA_ARGS__); } while (0)
 
+#endif // FUNCS_H
@@ -0,0 +1,41 @@
+// functional.c
+// Architectural-only execution: same semantics as the 5-stage model, no timing
+#include <stdbool.h>
+#include <stdint.h>
+#include "registers.h"
+#include "memory.h"
+#include "funcs.h"
+#include "pipelineRun.h"
+#include "functional.h"
+#include "hooks.h"
+
+bool program_halted() {
+    return PC >= (uint32_t)total_instructions || instruction_memory[PC] == 0;
+}
+
+bool functional_step() {
+    if (program_halted()) return false;
+
+    // Reuse the stage functions so both models share one definition of each instruction
+    Instruction instr;
+    uint32_t address = PC;
+    bool saved_trace = trace_enabled;
+    trace_enabled = false;
+
+    instruction_decode(instruction_memory[address], &instr);
+    uint32_t result = execute(&instr, address);
+    HOOK_SET_PC(address);
+    memory_access(memory, &instr);
+    write_back(&instr, result);
+
+    // Taken JEQ/JMP redirect exactly like flush_pipeline_after_wb()
+    if (flush_flag) {
+        PC = branch_target;
+        flush_flag = 0;
+    } else {
+        PC = address + 1;
+    }
+
+    trace_enabled = saved_trace;
+    return true;
+}
@@ -0,0 +1,14 @@
+#ifndef FUNCTIONAL_H
+#define FUNCTIONAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// True once PC has run past the loaded program (same end condition as the pipeline's fetch)
+bool program_halted(void);
+
+// Execute the instruction at PC to completion with no pipeline timing and advance PC.
+// Returns false (and does nothing) if the program has already halted.
+bool functional_step(void);
+
+#endif // FUNCTIONAL_H
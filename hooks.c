@@ -0,0 +1,38 @@
+// hooks.c
+// Instrumentation hook registry
+#include <stdint.h>
+#include <stdbool.h>
+#include "hooks.h"
+
+#ifdef PIPELINE_NO_HOOKS
+int register_hook(HookEvent event, HookFn fn, void *user) {
+    (void)event;
+    (void)fn;
+    (void)user;
+    return -1;
+}
+#else
+typedef struct {
+    HookFn fn;
+    void *user;
+} HookSlot;
+
+unsigned hooks_active = 0;
+CORE_LOCAL uint32_t hook_pc = 0;
+
+static HookSlot hooks[HOOK_EVENT_COUNT][MAX_HOOKS_PER_EVENT];
+static int hook_count[HOOK_EVENT_COUNT];
+
+int register_hook(HookEvent event, HookFn fn, void *user) {
+    if (event >= HOOK_EVENT_COUNT || !fn || hook_count[event] == MAX_HOOKS_PER_EVENT) return -1;
+    hooks[event][hook_count[event]++] = (HookSlot){fn, user};
+    hooks_active |= HOOK_BIT(event);
+    return 0;
+}
+
+void run_hooks(const HookInfo *info) {
+    for (int i = 0; i < hook_count[info->event]; i++) {
+        hooks[info->event][i].fn(info, hooks[info->event][i].user);
+    }
+}
+#endif
@@ -0,0 +1,73 @@
+#ifndef HOOKS_H
+#define HOOKS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "corelocal.h"
+
+// Instrumentation hooks. Callbacks are registered at startup and called with a
+// HookInfo at each event site. A site costs one predictable branch on
+// `hooks_active` while nothing is registered for its event, and nothing at all
+// when built with -DPIPELINE_NO_HOOKS (the arguments are not even evaluated).
+//
+// Sites:
+//   HOOK_FETCH           instruction_fetch()             pc, instruction
+//   HOOK_DECODE          ID hands an instruction to EX   pc, instruction
+//   HOOK_STALL           ID holds for a hazard           pc, instruction
+//   HOOK_RETIRE          WB, or commit in --ooo          pc, instruction
+//   HOOK_FLUSH           taken JEQ/JMP flushes at WB     pc (branch), value (target)
+//   HOOK_REGISTER_WRITE  safe_register_write()           location (register), value, old_value
+//   HOOK_MEMORY_ACCESS   memory_access()                 location (address), value, old_value, is_store
+// `pc` of register writes and memory accesses is the instruction in WB/MEM.
+
+typedef enum {
+    HOOK_FETCH,
+    HOOK_DECODE,
+    HOOK_STALL,
+    HOOK_RETIRE,
+    HOOK_FLUSH,
+    HOOK_REGISTER_WRITE,
+    HOOK_MEMORY_ACCESS,
+    HOOK_EVENT_COUNT
+} HookEvent;
+
+typedef struct {
+    HookEvent event;
+    uint32_t pc;
+    uint32_t instruction;
+    uint32_t location;   // Register index or memory address
+    uint32_t value;      // Value written or read; flush target
+    uint32_t old_value;  // Value before a register or memory write
+    bool is_store;
+} HookInfo;
+
+typedef void (*HookFn)(const HookInfo *info, void *user);
+
+#define MAX_HOOKS_PER_EVENT 8
+#define HOOK_BIT(event) (1u << (event))
+
+// Returns 0 on success, -1 if the event is full or hooks were compiled out
+int register_hook(HookEvent event, HookFn fn, void *user);
+
+#ifdef PIPELINE_NO_HOOKS
+#define HOOK(ev, ...) do { } while (0)
+#define HOOK_SET_PC(pc) do { } while (0)
+#else
+extern unsigned hooks_active;          // HOOK_BIT of every event with a registered hook
+extern CORE_LOCAL uint32_t hook_pc;   // Instruction whose register/memory effects are being applied
+
+void run_hooks(const HookInfo *info);
+
+// HOOK(HOOK_FETCH, .pc = PC, .instruction = instr);
+#define HOOK(ev, ...)                                                 \
+    do {                                                              \
+        if (__builtin_expect(hooks_active & HOOK_BIT(ev), 0)) {      \
+            HookInfo hook_info_ = {.event = (ev), __VA_ARGS__};       \
+            run_hooks(&hook_info_);                                   \
+        }                                                             \
+    } while (0)
+
+#define HOOK_SET_PC(pc) do { if (__builtin_expect(hooks_active != 0, 0)) hook_pc = (pc); } while (0)
+#endif
+
+#endif // HOOKS_H
@@ -0,0 +1,199 @@
+// memo.c
+// Steady-state loop detection: memoize per-segment pipeline timing
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "registers.h"
+#include "memory.h"
+#include "funcs.h"
+#include "pipelineRun.h"
+#include "functional.h"
+#include "memo.h"
+
+#define MEMO_TABLE_SIZE 4096 // Power of two
+#define MEMO_MAX_SEGMENT 4096 // Longest segment (instructions) tried functionally
+
+#define FNV_OFFSET 1469598103934665603ull
+#define FNV_PRIME 1099511628211ull
+
+typedef struct {
+    bool used;
+    uint32_t start_pc;
+    uint32_t count;     // Instructions in the segment
+    uint64_t signature;
+    int cycles;         // Clock cycles from the segment's first cycle to its flush
+    int fetched;        // Fetches, including the flushed wrong-path ones
+} MemoEntry;
+
+// Signature of the segment being built, in program order
+typedef struct {
+    uint32_t start_pc;
+    uint32_t count;
+    uint64_t hash;
+    uint8_t prev_opcode[2];  // Previous two instructions (the ones that can still
+    uint32_t prev_address[2]; // be in EX/MEM when a MOVR sits in ID)
+} Signature;
+
+bool memo_enabled = false;
+
+static MemoEntry memo_table[MEMO_TABLE_SIZE];
+static Signature current;
+static bool segment_open = false;
+static int segment_start_cycle = 0;
+static int segment_start_fetched = 0;
+
+static uint64_t memo_hits = 0;
+static uint64_t memo_misses = 0;
+static uint64_t cycles_skipped = 0;
+static uint64_t instructions_skipped = 0;
+
+static void signature_start(Signature *sig, uint32_t start_pc) {
+    memset(sig, 0, sizeof(*sig));
+    sig->start_pc = start_pc;
+    sig->hash = FNV_OFFSET;
+    sig->prev_opcode[0] = sig->prev_opcode[1] = 0xFF;
+}
+
+static void signature_mix(Signature *sig, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        sig->hash ^= (value >> (8 * i)) & 0xFF;
+        sig->hash *= FNV_PRIME;
+    }
+}
+
+// Fold one executed instruction into the signature
+static void signature_add(Signature *sig, uint32_t pc, uint8_t opcode, uint32_t mem_address) {
+    uint32_t matches = 0;
+    if (opcode == 9) { // MOVR: only equality with an older in-flight MOVM changes timing
+        for (int i = 0; i < 2; i++) {
+            if (sig->prev_opcode[i] == 10 && sig->prev_address[i] == mem_address) {
+                matches |= 1u << i;
+            }
+        }
+    }
+    signature_mix(sig, pc);
+    signature_mix(sig, matches);
+    sig->count++;
+
+    sig->prev_opcode[1] = sig->prev_opcode[0];
+    sig->prev_address[1] = sig->prev_address[0];
+    sig->prev_opcode[0] = opcode;
+    sig->prev_address[0] = mem_address;
+}
+
+static MemoEntry *memo_lookup(const Signature *sig, bool insert) {
+    uint32_t slot = (uint32_t)(sig->hash ^ sig->start_pc) & (MEMO_TABLE_SIZE - 1);
+    for (int probe = 0; probe < MEMO_TABLE_SIZE; probe++) {
+        MemoEntry *entry = &memo_table[(slot + probe) & (MEMO_TABLE_SIZE - 1)];
+        if (!entry->used) return insert ? entry : NULL;
+        if (entry->start_pc == sig->start_pc && entry->count == sig->count && entry->signature == sig->hash) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+void memo_note_execute(const PipelineStage *stage) {
+    if (!segment_open) return;
+    const Instruction *instr = &stage->decoded;
+    uint32_t mem_address = 0;
+    if (instr->opcode == 9 || instr->opcode == 10) {
+        mem_address = registers[instr->r2] + instr->imm;
+    }
+    signature_add(&current, stage->instruction_address, instr->opcode, mem_address);
+}
+
+// Execute one segment functionally. Returns the matching entry, or NULL after
+// undoing every register, PC and memory change if the segment is not known.
+static MemoEntry *try_skip_segment(void) {
+    static uint32_t undo_address[MEMO_MAX_SEGMENT];
+    static uint32_t undo_value[MEMO_MAX_SEGMENT];
+    uint32_t saved_registers[NUM_REGISTERS];
+    uint32_t saved_pc = PC;
+    int undo_count = 0;
+    bool ended = false;
+    Signature sig;
+
+    memcpy(saved_registers, registers, sizeof(saved_registers));
+    signature_start(&sig, PC);
+
+    while (sig.count < MEMO_MAX_SEGMENT && !program_halted()) {
+        Instruction instr;
+        uint32_t pc = PC;
+        uint32_t mem_address = 0;
+        instruction_decode(instruction_memory[pc], &instr);
+        if (instr.opcode == 9 || instr.opcode == 10) {
+            mem_address = registers[instr.r2] + instr.imm;
+            if (instr.opcode == 10 && mem_address < MEMORY_SIZE) {
+                undo_address[undo_count] = mem_address;
+                undo_value[undo_count++] = memory[mem_address];
+            }
+        }
+        bool taken = instr.opcode == 11 || (instr.opcode == 7 && registers[instr.r1] == registers[instr.r2]);
+
+        functional_step();
+        signature_add(&sig, pc, instr.opcode, mem_address);
+        if (taken) {
+            ended = true;
+            break;
+        }
+    }
+
+    MemoEntry *entry = ended ? memo_lookup(&sig, false) : NULL;
+    if (!entry) {
+        while (undo_count > 0) {
+            undo_count--;
+            memory_write(undo_address[undo_count], undo_value[undo_count]);
+        }
+        memcpy(registers, saved_registers, sizeof(saved_registers));
+        PC = saved_pc;
+    }
+    return entry;
+}
+
+void memo_segment_boundary(int *clock_cycle) {
+    // Remember the timing of the segment that has just been simulated in detail
+    if (segment_open) {
+        MemoEntry *entry = memo_lookup(&current, true);
+        if (entry && !entry->used) {
+            entry->used = true;
+            entry->start_pc = current.start_pc;
+            entry->count = current.count;
+            entry->signature = current.hash;
+            entry->cycles = *clock_cycle - segment_start_cycle;
+            entry->fetched = instructions_fetched - segment_start_fetched;
+        }
+        segment_open = false;
+    }
+
+    // Skip ahead while the next segment repeats one we have already timed
+    MemoEntry *hit;
+    int skipped = 0;
+    while ((hit = try_skip_segment()) != NULL) {
+        *clock_cycle += hit->cycles;
+        instructions_executed += hit->count;
+        instructions_fetched += hit->fetched;
+        memo_hits++;
+        cycles_skipped += hit->cycles;
+        instructions_skipped += hit->count;
+        skipped++;
+    }
+    memo_misses++;
+    if (skipped > 0) {
+        TRACE("[MEMO] Skipped %d known segments; resuming detailed simulation at cycle %d, PC %u\n", skipped, *clock_cycle, PC);
+    }
+
+    signature_start(&current, PC);
+    segment_start_cycle = *clock_cycle;
+    segment_start_fetched = instructions_fetched;
+    segment_open = true;
+}
+
+void memo_print_stats() {
+    printf("\n======= Steady-State Memoization =======\n");
+    printf("Segments skipped     : %llu\n", (unsigned long long)memo_hits);
+    printf("Segments simulated   : %llu\n", (unsigned long long)memo_misses);
+    printf("Cycles skipped       : %llu\n", (unsigned long long)cycles_skipped);
+    printf("Instructions skipped : %llu\n", (unsigned long long)instructions_skipped);
+}
@@ -0,0 +1,29 @@
+#ifndef MEMO_H
+#define MEMO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pipelineRun.h"
+
+// Steady-state fast-forward. Every taken JEQ/JMP flushes the whole pipeline at
+// WB, so the code between two flushes (a "segment", e.g. one loop iteration)
+// always starts from an empty pipeline and its timing depends only on the
+// instructions it executes and on which MOVR addresses match an in-flight MOVM.
+// Segments are keyed by their start PC and a signature of exactly that; once a
+// segment has been timed in detail, later identical iterations run functionally
+// and advance the clock by the remembered cycle delta.
+
+extern bool memo_enabled;
+
+// Called by EX for every instruction it completes so the running segment's signature is known
+void memo_note_execute(const PipelineStage *stage);
+
+// Called between cycles right after a flush: records the segment that just
+// ended and skips following segments whose timing is already known.
+// *clock_cycle is the next cycle to simulate and is advanced past skipped segments.
+void memo_segment_boundary(int *clock_cycle);
+
+// Print hit/miss and skipped-cycle counts
+void memo_print_stats(void);
+
+#endif // MEMO_H
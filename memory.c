@@ -3,28 +3,79 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <stdbool.h>
 #include "memory.h"
 
 #define MEMORY_SIZE 2048
 #define INSTRUCTION_SEGMENT_LIMIT 1024
 
 uint32_t memory[MEMORY_SIZE]; // Unified instruction + data memory
-uint32_t instruction_memory[MAX_INSTRUCTIONS] = {0};
+CORE_LOCAL uint32_t instruction_memory[MAX_INSTRUCTIONS] = {0};
 
 // In memory.c
 uint32_t memory[MEMORY_SIZE] = {0};
+uint64_t memory_dirty_words[MEMORY_PAGES];
+uint64_t memory_dirty_pages[(MEMORY_PAGES + 63) / 64];
+
+// Words written since the last delta report, with their value before the first such write
+static uint64_t delta_words[MEMORY_PAGES];
+static uint64_t delta_pages[(MEMORY_PAGES + 63) / 64];
+static uint32_t delta_old[MEMORY_SIZE];
+
+// Next word marked in a page/word bitmap pair at or after `address`; MEMORY_SIZE when none is left
+static uint32_t next_marked(const uint64_t *pages, const uint64_t *words, uint32_t address) {
+    while (address < MEMORY_SIZE) {
+        uint32_t page = address / MEMORY_PAGE_WORDS;
+        if (pages[page / 64] & (1ull << (page % 64))) {
+            uint64_t rest = words[page] >> (address % MEMORY_PAGE_WORDS);
+            if (rest) return address + __builtin_ctzll(rest);
+        }
+        address = (page + 1) * MEMORY_PAGE_WORDS;
+    }
+    return MEMORY_SIZE;
+}
+
 // === Initialize memory to 0 ===
 void init_memory() {
     for (int i = 0; i < MEMORY_SIZE; i++) {
         memory[i] = 0;
     }
+    memset(memory_dirty_words, 0, sizeof(memory_dirty_words));
+    memset(memory_dirty_pages, 0, sizeof(memory_dirty_pages));
+    memset(delta_words, 0, sizeof(delta_words));
+    memset(delta_pages, 0, sizeof(delta_pages));
+}
+
+void memory_write(uint32_t address, uint32_t value) {
+    uint32_t page = address / MEMORY_PAGE_WORDS;
+    uint64_t bit = 1ull << (address % MEMORY_PAGE_WORDS);
+    if (!(delta_words[page] & bit)) {
+        delta_words[page] |= bit;
+        delta_pages[page / 64] |= 1ull << (page % 64);
+        delta_old[address] = memory[address];
+    }
+    memory_dirty_words[page] |= bit;
+    memory_dirty_pages[page / 64] |= 1ull << (page % 64);
+    memory[address] = value;
+}
+
+void memory_rebuild_dirty() {
+    memset(memory_dirty_words, 0, sizeof(memory_dirty_words));
+    memset(memory_dirty_pages, 0, sizeof(memory_dirty_pages));
+    for (uint32_t i = 0; i < MEMORY_SIZE; i++) {
+        if (memory[i] != 0) {
+            memory_dirty_words[i / MEMORY_PAGE_WORDS] |= 1ull << (i % MEMORY_PAGE_WORDS);
+            memory_dirty_pages[i / MEMORY_PAGE_WORDS / 64] |= 1ull << (i / MEMORY_PAGE_WORDS % 64);
+        }
+    }
+    memory_delta_reset();
 }
 
 // === Write encoded instruction array into memory segment 0–1023 ===
 void write_instruction_memory(uint32_t *instruction_array) {
     int i = 0;
     while (i < INSTRUCTION_SEGMENT_LIMIT && instruction_array[i] != 0) {
-        memory[i] = instruction_array[i];
+        memory_write(i, instruction_array[i]);
         i++;
     }
     printf("\nInstructions successfully written to instruction memory\n", i - 1);
@@ -39,21 +90,109 @@ uint32_t read_memory(uint32_t address) {
     return memory[address];
 }
 
+// "0b 0110 0000 ..." with a space between nibbles, as one string
+static void format_binary(uint32_t value, char *out) {
+    char *p = out;
+    for (int bit = 31; bit >= 0; bit--) {
+        *p++ = '0' + ((value >> bit) & 1);
+        if (bit % 4 == 0 && bit > 0) *p++ = ' ';
+    }
+    *p = '\0';
+}
+
 void print_memory() {
+    char binary[40];
     printf("\n======= Non-Zero Memory Locations =======\n");
-    for (int i = 0; i < MEMORY_SIZE; i++) {
+    // Memory starts zeroed, so only written words can be non-zero
+    for (uint32_t i = next_marked(memory_dirty_pages, memory_dirty_words, 0); i < MEMORY_SIZE;
+         i = next_marked(memory_dirty_pages, memory_dirty_words, i + 1)) {
         uint32_t value = memory[i];
         if (value != 0) {
-            printf("Memory[%4d] = 0b ", i);
-            for (int bit = 31; bit >= 0; bit--) {
-                printf("%d", (value >> bit) & 1);
-                if (bit % 4 == 0 && bit > 0) {
-                    printf(" ");
-                }
-            }
-            printf("\n");
+            format_binary(value, binary);
+            printf("Memory[%4u] = 0b %s\n", i, binary);
         }
     }
-    
-           
+}
+
+void memory_delta_reset() {
+    for (uint32_t page = 0; page < MEMORY_PAGES; page++) {
+        if (delta_pages[page / 64] & (1ull << (page % 64))) delta_words[page] = 0;
+    }
+    memset(delta_pages, 0, sizeof(delta_pages));
+}
+
+void memory_delta_report(const char *label) {
+    int written = 0;
+    int changed = 0;
+    printf("\n======= Memory Delta (%s) =======\n", label);
+    for (uint32_t address = next_marked(delta_pages, delta_words, 0); address < MEMORY_SIZE;
+         address = next_marked(delta_pages, delta_words, address + 1)) {
+        written++;
+        if (delta_old[address] != memory[address]) {
+            changed++;
+            printf("Memory[%4u]: %d -> %d\n", address, (int32_t)delta_old[address], (int32_t)memory[address]);
+        }
+    }
+    printf("%d words written, %d changed\n", written, changed);
+    memory_delta_reset();
+}
+
+int save_memory_image(const char *path) {
+    FILE *file = fopen(path, "w");
+    if (!file) {
+        perror("Error opening memory image");
+        return -1;
+    }
+    fprintf(file, "# memory image: address value\n");
+    for (uint32_t address = next_marked(memory_dirty_pages, memory_dirty_words, 0); address < MEMORY_SIZE;
+         address = next_marked(memory_dirty_pages, memory_dirty_words, address + 1)) {
+        if (memory[address] != 0) fprintf(file, "%u %u\n", address, memory[address]);
+    }
+    fclose(file);
+    return 0;
+}
+
+int compare_memory_image(const char *path) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        perror("Error opening memory image");
+        return -1;
+    }
+    // Words named by the image; every other word of the image is zero
+    uint64_t seen[MEMORY_PAGES] = {0};
+    int compared = 0;
+    int differ = 0;
+    char line[128];
+    printf("\n======= Memory Compared With %s =======\n", path);
+    while (fgets(line, sizeof(line), file)) {
+        uint32_t address, value;
+        if (line[0] == '#' || sscanf(line, "%u %u", &address, &value) != 2) continue;
+        if (address >= MEMORY_SIZE) {
+            fprintf(stderr, "Memory image %s: address %u out of bounds\n", path, address);
+            fclose(file);
+            return -1;
+        }
+        seen[address / MEMORY_PAGE_WORDS] |= 1ull << (address % MEMORY_PAGE_WORDS);
+        compared++;
+        if (memory[address] != value) {
+            differ++;
+            printf("Memory[%4u]: image %d, this run %d\n", address, (int32_t)value, (int32_t)memory[address]);
+        }
+    }
+    fclose(file);
+    for (uint32_t address = next_marked(memory_dirty_pages, memory_dirty_words, 0); address < MEMORY_SIZE;
+         address = next_marked(memory_dirty_pages, memory_dirty_words, address + 1)) {
+        bool in_image = seen[address / MEMORY_PAGE_WORDS] & (1ull << (address % MEMORY_PAGE_WORDS));
+        if (!in_image && memory[address] != 0) {
+            compared++;
+            differ++;
+            printf("Memory[%4u]: image 0, this run %d\n", address, (int32_t)memory[address]);
+        }
+    }
+    if (differ) {
+        printf("%d of %d words differ\n", differ, compared);
+    } else {
+        printf("Memory matches (%d words compared)\n", compared);
+    }
+    return differ;
 }
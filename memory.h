@@ -1,12 +1,39 @@
 #ifndef MEMORY_H
 #define MEMORY_H
 
+#include <stdint.h>
+#include "corelocal.h"
+
 #define MEMORY_SIZE 2048
 #define MAX_INSTRUCTIONS 1024
 
 extern uint32_t memory[MEMORY_SIZE];
-extern uint32_t instruction_memory[MAX_INSTRUCTIONS];
+extern CORE_LOCAL uint32_t instruction_memory[MAX_INSTRUCTIONS]; // Private to each core
+
+// Dirty tracking: one bit per word written since init_memory(), grouped into
+// pages, plus one bit per page holding any such word. Dumps, deltas and run
+// comparisons walk only these bits, so they cost what the program wrote.
+#define MEMORY_PAGE_WORDS 64
+#define MEMORY_PAGES (MEMORY_SIZE / MEMORY_PAGE_WORDS)
+
+extern uint64_t memory_dirty_words[MEMORY_PAGES];
+extern uint64_t memory_dirty_pages[(MEMORY_PAGES + 63) / 64];
 
 void init_memory(void);
 
+// Every write to data memory goes through here so the dirty bits stay exact
+void memory_write(uint32_t address, uint32_t value);
+
+// Mark every non-zero word dirty after memory was filled in bulk (checkpoint restore)
+void memory_rebuild_dirty(void);
+
+// Print the words that changed since the previous delta (or memory_delta_reset) and start a new one
+void memory_delta_report(const char *label);
+void memory_delta_reset(void);
+
+// Sparse text image of memory ("address value" per non-zero word), and a
+// comparison of the current memory against one; returns the number of differing words
+int save_memory_image(const char *path);
+int compare_memory_image(const char *path);
+
 #endif // MEMORY_H
\ No newline at end of file
@@ -0,0 +1,193 @@
+// memprofile.c
+// MOVR/MOVM address-stream profiler and stride prefetcher model
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "memory.h"
+#include "memprofile.h"
+
+#define REUSE_BUCKETS 12      // 0, 1, 2-3, 4-7, ... and everything from 1024 up
+#define CONFIDENCE_MAX 3
+#define CONFIDENCE_PREDICT 2  // Prefetch once the same stride has been seen twice in a row
+#define HEATMAP_WIDTH 50
+
+typedef struct {
+    uint64_t loads;
+    uint64_t stores;
+    uint32_t min_address;
+    uint32_t max_address;
+    uint32_t last_address;
+    int32_t stride;           // Reference prediction table: last confirmed stride
+    int confidence;
+    uint64_t stride_repeats;  // Accesses whose stride equalled the previous one
+} PcStream;
+
+bool mem_profile_enabled = false;
+
+static PcStream streams[MAX_INSTRUCTIONS];
+
+static uint64_t bucket_reads[MEMORY_SIZE / MEM_PROFILE_BUCKET];
+static uint64_t bucket_writes[MEMORY_SIZE / MEM_PROFILE_BUCKET];
+
+// Reuse distance: each address's last access time, and the addresses touched so far
+static uint64_t access_clock = 0;
+static uint64_t last_access[MEMORY_SIZE];
+static uint32_t touched[MEMORY_SIZE];
+static int touched_count = 0;
+static uint64_t reuse_histogram[REUSE_BUCKETS];
+static uint64_t cold_accesses = 0;
+
+// Prefetched addresses not yet demanded; a load that finds its address consumes the entry
+static uint32_t prefetch_buffer[PREFETCH_BUFFER_ENTRIES];
+static bool prefetch_live[PREFETCH_BUFFER_ENTRIES];
+static int prefetch_next = 0; // FIFO replacement
+static uint64_t prefetches_issued = 0;
+static uint64_t loads_covered = 0;
+static uint64_t total_loads = 0;
+
+static int reuse_bucket(uint64_t distance) {
+    int bucket = 0;
+    while (distance > 0 && bucket < REUSE_BUCKETS - 1) {
+        distance >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+static void record_reuse(uint32_t address) {
+    access_clock++;
+    if (last_access[address] == 0) {
+        cold_accesses++;
+        touched[touched_count++] = address;
+    } else {
+        uint64_t distance = 0;
+        for (int i = 0; i < touched_count; i++) {
+            if (last_access[touched[i]] > last_access[address]) distance++;
+        }
+        reuse_histogram[reuse_bucket(distance)]++;
+    }
+    last_access[address] = access_clock;
+}
+
+static int prefetch_lookup(uint32_t address) {
+    for (int i = 0; i < PREFETCH_BUFFER_ENTRIES; i++) {
+        if (prefetch_live[i] && prefetch_buffer[i] == address) return i;
+    }
+    return -1;
+}
+
+static void prefetch_issue(uint32_t address) {
+    if (address >= MEMORY_SIZE || prefetch_lookup(address) >= 0) return;
+    prefetch_buffer[prefetch_next] = address;
+    prefetch_live[prefetch_next] = true;
+    prefetch_next = (prefetch_next + 1) % PREFETCH_BUFFER_ENTRIES;
+    prefetches_issued++;
+}
+
+void mem_profile_record(uint32_t pc, uint32_t address, bool is_store) {
+    if (pc >= MAX_INSTRUCTIONS || address >= MEMORY_SIZE) return;
+    PcStream *s = &streams[pc];
+    uint64_t previous = s->loads + s->stores;
+
+    if (is_store) {
+        s->stores++;
+        bucket_writes[address / MEM_PROFILE_BUCKET]++;
+    } else {
+        s->loads++;
+        bucket_reads[address / MEM_PROFILE_BUCKET]++;
+        total_loads++;
+        int hit = prefetch_lookup(address);
+        if (hit >= 0) {
+            loads_covered++;
+            prefetch_live[hit] = false;
+        }
+    }
+    record_reuse(address);
+
+    if (previous == 0) {
+        s->min_address = s->max_address = address;
+    } else {
+        if (address < s->min_address) s->min_address = address;
+        if (address > s->max_address) s->max_address = address;
+        int32_t stride = (int32_t)(address - s->last_address);
+        if (previous > 1 && stride == s->stride) {
+            s->stride_repeats++;
+            if (s->confidence < CONFIDENCE_MAX) s->confidence++;
+        } else if (s->confidence > 0) {
+            s->confidence--;
+        } else {
+            s->stride = stride;
+        }
+        // Only loads train the prefetcher; stores have nothing to wait for
+        if (!is_store && s->confidence >= CONFIDENCE_PREDICT && s->stride != 0) {
+            prefetch_issue(address + s->stride);
+        }
+    }
+    s->last_address = address;
+}
+
+static const char *stream_pattern(const PcStream *s, char *buffer, size_t size) {
+    uint64_t accesses = s->loads + s->stores;
+    if (accesses < 3) return "too short";
+    if (s->min_address == s->max_address) return "constant address";
+    // A stride that repeats for at least three quarters of the access pairs
+    if (s->stride_repeats * 4 >= (accesses - 2) * 3) {
+        snprintf(buffer, size, "stride %d", s->stride);
+        return buffer;
+    }
+    return "irregular";
+}
+
+void mem_profile_print(void) {
+    printf("\n======= Memory Access Profile =======\n");
+    printf("  PC  Kind     Loads   Stores  Address range  Pattern\n");
+    for (int pc = 0; pc < MAX_INSTRUCTIONS; pc++) {
+        PcStream *s = &streams[pc];
+        if (!s->loads && !s->stores) continue;
+        char pattern[32];
+        printf("%4d  %-5s %8llu %8llu  [%4u, %4u]   %s\n", pc, s->stores ? "MOVM" : "MOVR",
+               (unsigned long long)s->loads, (unsigned long long)s->stores, s->min_address, s->max_address,
+               stream_pattern(s, pattern, sizeof(pattern)));
+    }
+
+    uint64_t hottest = 0;
+    for (int b = 0; b < MEMORY_SIZE / MEM_PROFILE_BUCKET; b++) {
+        if (bucket_reads[b] + bucket_writes[b] > hottest) hottest = bucket_reads[b] + bucket_writes[b];
+    }
+    printf("\nHeatmap (%d-word regions, r = reads, w = writes):\n", MEM_PROFILE_BUCKET);
+    for (int b = 0; b < MEMORY_SIZE / MEM_PROFILE_BUCKET; b++) {
+        uint64_t total = bucket_reads[b] + bucket_writes[b];
+        if (!total) continue;
+        int width = (int)((total * HEATMAP_WIDTH + hottest - 1) / hottest);
+        int reads = (int)((bucket_reads[b] * width + total / 2) / total);
+        printf("[%4d-%4d] %8llu |", b * MEM_PROFILE_BUCKET, (b + 1) * MEM_PROFILE_BUCKET - 1, (unsigned long long)total);
+        for (int i = 0; i < width; i++) putchar(i < reads ? 'r' : 'w');
+        putchar('\n');
+    }
+
+    printf("\nReuse distance (distinct addresses in between):\n");
+    printf("  cold      %llu\n", (unsigned long long)cold_accesses);
+    for (int b = 0; b < REUSE_BUCKETS; b++) {
+        if (!reuse_histogram[b]) continue;
+        char range[16];
+        int low = b ? 1 << (b - 1) : 0;
+        int high = b ? (1 << b) - 1 : 0;
+        if (b == REUSE_BUCKETS - 1) {
+            snprintf(range, sizeof(range), "%d+", low);
+        } else if (low == high) {
+            snprintf(range, sizeof(range), "%d", low);
+        } else {
+            snprintf(range, sizeof(range), "%d-%d", low, high);
+        }
+        printf("  %-9s %llu\n", range, (unsigned long long)reuse_histogram[b]);
+    }
+
+    printf("\nStride prefetcher (%d-entry buffer):\n", PREFETCH_BUFFER_ENTRIES);
+    printf("Prefetches issued : %llu\n", (unsigned long long)prefetches_issued);
+    // Each prefetch can cover at most one load, so covered loads are also the useful prefetches
+    printf("Accuracy          : %.1f%% (%llu used)\n",
+           prefetches_issued ? 100.0 * loads_covered / prefetches_issued : 0.0, (unsigned long long)loads_covered);
+    printf("Coverage          : %.1f%% (%llu of %llu loads)\n",
+           total_loads ? 100.0 * loads_covered / total_loads : 0.0, (unsigned long long)loads_covered,
+           (unsigned long long)total_loads);
+}
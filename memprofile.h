@@ -0,0 +1,28 @@
+#ifndef MEM_PROFILE_H
+#define MEM_PROFILE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Memory access profiler. Every MOVR/MOVM that completes MEM is recorded
+// against its PC, and the report shows:
+//  - per-PC address streams: count, address range and dominant stride
+//  - a heatmap of reads and writes over MEM_PROFILE_BUCKET-word regions
+//  - a reuse-distance histogram: distinct addresses touched between two
+//    accesses to the same address (log2 buckets)
+//  - a modeled stride prefetcher: a per-PC reference prediction table that,
+//    once a load's stride has repeated, prefetches the next address into a
+//    small FIFO buffer. Accuracy is the fraction of prefetches a later load
+//    used; coverage is the fraction of loads that found their address there.
+
+#define MEM_PROFILE_BUCKET 32
+#define PREFETCH_BUFFER_ENTRIES 16
+
+extern bool mem_profile_enabled;
+
+// Record one data access made by the instruction at `pc`
+void mem_profile_record(uint32_t pc, uint32_t address, bool is_store);
+
+void mem_profile_print(void);
+
+#endif // MEM_PROFILE_H
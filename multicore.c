@@ -0,0 +1,225 @@
+// multicore.c
+// N pipelines over the unified memory, one host thread per simulated core
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <pthread.h>
+#include "registers.h"
+#include "memory.h"
+#include "funcs.h"
+#include "pipelineRun.h"
+#include "multicore.h"
+
+typedef struct {
+    int cycle;
+    int core;
+    uint32_t address;
+    uint32_t value;
+} BufferedStore;
+
+typedef struct {
+    int id;
+    const char *program;
+    pthread_t thread;
+    int status;
+
+    // Stores made during the current quantum (at most one per cycle)
+    BufferedStore *stores;
+    int store_count;
+
+    // Results, copied out of the thread-local state when the core stops
+    bool done;
+    int cycles;
+    int committed;
+    int fetched;
+    int flushes;
+    uint64_t fetch_port_stalls;
+    uint64_t mem_port_stalls;
+    uint32_t final_registers[NUM_REGISTERS];
+    uint32_t final_pc;
+} CoreContext;
+
+bool multicore_active = false;
+
+static CoreContext cores[MAX_CORES];
+static int core_count = 1;
+static int quantum_cycles = DEFAULT_QUANTUM;
+static long cycle_budget = 0;
+static bool stop_simulation = false;
+static pthread_barrier_t quantum_barrier;
+
+static CORE_LOCAL CoreContext *self = NULL;
+static CORE_LOCAL int current_cycle = 0;
+
+bool memory_port_granted(int clock_cycle, bool fetch) {
+    if (!multicore_active) return true;
+    if (clock_cycle % core_count == self->id) return true;
+    if (fetch) {
+        self->fetch_port_stalls++;
+    } else {
+        self->mem_port_stalls++;
+    }
+    TRACE("[BUS] Core %d denied the memory port for %s\n", self->id, fetch ? "IF" : "MEM");
+    return false;
+}
+
+uint32_t shared_memory_read(uint32_t address) {
+    // This core's own stores from the current quantum are visible immediately
+    for (int i = self->store_count - 1; i >= 0; i--) {
+        if (self->stores[i].address == address) return self->stores[i].value;
+    }
+    return memory[address];
+}
+
+void shared_memory_write(uint32_t address, uint32_t value) {
+    BufferedStore *store = &self->stores[self->store_count++];
+    store->cycle = current_cycle;
+    store->core = self->id;
+    store->address = address;
+    store->value = value;
+}
+
+static int compare_stores(const void *a, const void *b) {
+    const BufferedStore *x = a;
+    const BufferedStore *y = b;
+    if (x->cycle != y->cycle) return x->cycle < y->cycle ? -1 : 1;
+    return x->core - y->core;
+}
+
+// Runs on one thread between the two quantum barriers while all cores wait
+static void end_quantum(int quantum_end) {
+    static BufferedStore merged[MAX_CORES * 1024];
+    BufferedStore *all = merged;
+    int total = 0;
+    for (int c = 0; c < core_count; c++) total += cores[c].store_count;
+    if (total > (int)(sizeof(merged) / sizeof(merged[0]))) {
+        all = malloc(total * sizeof(BufferedStore));
+        if (!all) {
+            fprintf(stderr, "Multicore Error: out of memory merging stores\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    int n = 0;
+    for (int c = 0; c < core_count; c++) {
+        memcpy(&all[n], cores[c].stores, cores[c].store_count * sizeof(BufferedStore));
+        n += cores[c].store_count;
+        cores[c].store_count = 0;
+    }
+    qsort(all, n, sizeof(BufferedStore), compare_stores);
+    for (int i = 0; i < n; i++) {
+        memory_write(all[i].address, all[i].value);
+    }
+    if (all != merged) free(all);
+
+    bool all_done = true;
+    for (int c = 0; c < core_count; c++) {
+        if (!cores[c].done) all_done = false;
+    }
+    if (all_done || (cycle_budget > 0 && quantum_end > cycle_budget)) {
+        stop_simulation = true;
+    }
+}
+
+static void *core_main(void *arg) {
+    self = arg;
+    init_registers();
+    if (load_program(self->program) != 0) {
+        self->status = -1;
+        self->done = true;
+    }
+
+    for (int quantum_end = quantum_cycles; ; quantum_end += quantum_cycles) {
+        while (!self->done && current_cycle < quantum_end) {
+            if (pipeline_cycle(current_cycle)) {
+                self->done = true;
+                self->cycles = current_cycle + 1;
+            }
+            current_cycle++;
+        }
+
+        if (pthread_barrier_wait(&quantum_barrier) == PTHREAD_BARRIER_SERIAL_THREAD) {
+            end_quantum(quantum_end);
+        }
+        pthread_barrier_wait(&quantum_barrier);
+        if (stop_simulation) break;
+    }
+
+    if (!self->done) {
+        self->cycles = current_cycle;
+    }
+    self->committed = instructions_executed;
+    self->fetched = instructions_fetched;
+    self->flushes = flush_count;
+    memcpy(self->final_registers, registers, sizeof(self->final_registers));
+    self->final_pc = PC;
+    return NULL;
+}
+
+static void print_core_report(const CoreContext *core) {
+    printf("\n======= Core %d (%s) =======\n", core->id, core->program);
+    printf("Clock cycles: %d, Instructions committed: %d, CPI: %.3f%s\n", core->cycles, core->committed,
+           core->committed ? (double)core->cycles / core->committed : 0.0,
+           core->done ? "" : " [cycle budget reached]");
+    printf("Fetched: %d, Flushes: %d, Port stalls: %llu IF, %llu MEM\n", core->fetched, core->flushes,
+           (unsigned long long)core->fetch_port_stalls, (unsigned long long)core->mem_port_stalls);
+    for (int i = 1; i < NUM_REGISTERS; i++) {
+        if (core->final_registers[i] != 0) {
+            printf("R%-2d = %d\n", i, (int32_t)core->final_registers[i]);
+        }
+    }
+    printf("PC  = %u\n", core->final_pc);
+}
+
+int run_multicore(const char **programs, int program_count, int count, int quantum, long max_cycles) {
+    if (count < 1 || count > MAX_CORES || quantum < 1 || program_count < 1) {
+        fprintf(stderr, "Multicore Error: need 1-%d cores, a quantum >= 1 and a program\n", MAX_CORES);
+        return -1;
+    }
+
+    core_count = count;
+    quantum_cycles = quantum;
+    cycle_budget = max_cycles;
+    stop_simulation = false;
+    multicore_active = true;
+    pthread_barrier_init(&quantum_barrier, NULL, count);
+
+    int status = 0;
+    for (int c = 0; c < count; c++) {
+        memset(&cores[c], 0, sizeof(cores[c]));
+        cores[c].id = c;
+        cores[c].program = programs[c < program_count ? c : program_count - 1];
+        cores[c].stores = malloc(quantum * sizeof(BufferedStore));
+        if (!cores[c].stores) {
+            fprintf(stderr, "Multicore Error: out of memory\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    for (int c = 0; c < count; c++) {
+        if (pthread_create(&cores[c].thread, NULL, core_main, &cores[c]) != 0) {
+            fprintf(stderr, "Multicore Error: could not start thread for core %d\n", c);
+            exit(EXIT_FAILURE);
+        }
+    }
+    for (int c = 0; c < count; c++) {
+        pthread_join(cores[c].thread, NULL);
+        if (cores[c].status != 0) status = -1;
+    }
+    pthread_barrier_destroy(&quantum_barrier);
+
+    int total_cycles = 0;
+    int total_committed = 0;
+    for (int c = 0; c < count; c++) {
+        print_core_report(&cores[c]);
+        if (cores[c].cycles > total_cycles) total_cycles = cores[c].cycles;
+        total_committed += cores[c].committed;
+        free(cores[c].stores);
+    }
+    printf("\nSystem: %d cores, %d cycles, %d instructions, IPC %.3f\n", count, total_cycles, total_committed,
+           total_cycles ? (double)total_committed / total_cycles : 0.0);
+
+    multicore_active = false;
+    return status;
+}
@@ -0,0 +1,35 @@
+#ifndef MULTICORE_H
+#define MULTICORE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Multicore simulation: N copies of the 5-stage pipeline with private register
+// files and instruction memories sharing the unified data memory.
+//
+// The shared memory has one port. A time-division arbiter grants it to core
+// (cycle % N) each cycle, extending the single-core IF/MEM conflict across
+// cores: IF and MOVR/MOVM in MEM stall until their core owns the port.
+//
+// Every core runs on its own host thread. Threads advance a quantum of cycles
+// independently and meet at a barrier; stores made during a quantum are
+// buffered per core and applied in (cycle, core) order at the barrier, so
+// results do not depend on host scheduling.
+
+#define MAX_CORES 16
+#define DEFAULT_QUANTUM 100
+
+extern bool multicore_active;
+
+// True if this core may use the shared memory port in clock_cycle (always true single-core)
+bool memory_port_granted(int clock_cycle, bool fetch);
+
+// Shared-memory accessors used by memory_access() during a multicore run
+uint32_t shared_memory_read(uint32_t address);
+void shared_memory_write(uint32_t address, uint32_t value);
+
+// Run `cores` cores; core i runs programs[i], or the last program if fewer are given.
+// max_cycles of 0 means no limit. Returns 0 on success, -1 on failure.
+int run_multicore(const char **programs, int program_count, int cores, int quantum, long max_cycles);
+
+#endif // MULTICORE_H
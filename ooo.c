@@ -0,0 +1,470 @@
+// ooo.c
+// Out-of-order core: reservation stations, register renaming, reorder buffer
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "registers.h"
+#include "memory.h"
+#include "funcs.h"
+#include "pipelineRun.h"
+#include "superscalar.h"
+#include "ooo.h"
+#include "hooks.h"
+#include "watch.h"
+
+#define NO_TAG (-1)
+
+typedef struct {
+    uint32_t instruction;
+    uint32_t address;
+} FetchSlot;
+
+// Fetch and decode latches: a group of sequential instructions
+typedef struct {
+    FetchSlot slot[MAX_ISSUE_WIDTH];
+    int count;
+    int cycles_remaining;
+} FrontGroup;
+
+typedef struct {
+    bool busy;
+    uint32_t pc;
+    Instruction decoded;
+    bool done;          // Result (or store address and data) is known
+    uint32_t value;     // Result, loaded value or store data
+    bool is_load;
+    bool is_store;
+    bool addr_ready;    // Memory address computed in EX
+    bool mem_pending;   // Load waiting in the load/store queue
+    uint32_t address;
+    bool taken;         // JEQ resolved taken: flush when it commits
+    uint32_t target;
+    bool fault;         // Out-of-bounds access, reported only if it commits
+} RobEntry;
+
+typedef struct {
+    bool busy;
+    bool issued;
+    int rob;
+    uint32_t vj, vk;    // Operand values once available
+    int qj, qk;         // ROB entry producing the operand, NO_TAG when the value is present
+    int cycles_remaining;
+    bool awaiting_data; // MOVM whose address is done but whose data is still in flight
+} RsEntry;
+
+static RobEntry rob[OOO_ROB_SIZE];
+static int rob_head = 0, rob_count = 0;
+static RsEntry rs[OOO_RS_SIZE];
+static int rat[NUM_REGISTERS];  // Architectural register -> ROB entry of its newest producer
+static int lsq_count = 0;       // MOVR/MOVM entries in the ROB
+static FrontGroup fetch_group, decode_group;
+static int width = 2;
+
+// Statistics
+static long rob_occupancy_sum = 0;
+static int rob_occupancy_max = 0;
+static long stalls_rob_full = 0;     // Dispatch blocked: no free ROB entry
+static long stalls_rs_full = 0;      // Dispatch blocked: no free reservation station
+static long stalls_lsq_full = 0;     // Dispatch blocked: load/store queue full
+static long cycles_frontend = 0;     // Nothing decoded and ready to dispatch
+static long fetch_port_conflicts = 0;
+static long loads_forwarded = 0;
+static long loads_blocked = 0;       // Cycles a load waited on an older store's address or data
+static long mispredicts = 0;
+
+static int rob_index(int offset) {
+    return (rob_head + offset) % OOO_ROB_SIZE;
+}
+
+static bool writes_register(const Instruction *instr) {
+    return (instr->opcode <= 6 || instr->opcode == 8 || instr->opcode == 9) && instr->r1 != 0;
+}
+
+// Same arithmetic as execute(), on renamed operand values instead of registers
+static uint32_t alu_result(const Instruction *instr, uint32_t a, uint32_t b) {
+    switch (instr->opcode) {
+        case 0: return (uint32_t)((int32_t)a + (int32_t)b);
+        case 1: return (uint32_t)((int32_t)a - (int32_t)b);
+        case 2: return (uint32_t)((int32_t)a * (int32_t)b);
+        case 3: return a & b;
+        case 4: return a << (instr->shamt & 0x1FFF);
+        case 5: return a >> (instr->shamt & 0x1FFF);
+        case 6: return (uint32_t)instr->imm;
+        case 8: return a ^ (uint32_t)instr->imm;
+        default: return 0;
+    }
+}
+
+static void read_operand(uint8_t reg, uint32_t *value, int *tag) {
+    *tag = NO_TAG;
+    *value = 0;
+    if (reg == 0) return;
+    int producer = rat[reg];
+    if (producer == NO_TAG) {
+        *value = registers[reg];
+    } else if (rob[producer].done) {
+        *value = rob[producer].value;
+    } else {
+        *tag = producer;
+    }
+}
+
+// Common data bus: hand a finished result to every station waiting on it
+static void broadcast(int tag, uint32_t value) {
+    for (int i = 0; i < OOO_RS_SIZE; i++) {
+        if (!rs[i].busy) continue;
+        if (rs[i].qj == tag) { rs[i].vj = value; rs[i].qj = NO_TAG; }
+        if (rs[i].qk == tag) { rs[i].vk = value; rs[i].qk = NO_TAG; }
+    }
+}
+
+static void reset_ooo(void) {
+    memset(rob, 0, sizeof(rob));
+    memset(rs, 0, sizeof(rs));
+    for (int r = 0; r < NUM_REGISTERS; r++) rat[r] = NO_TAG;
+    rob_head = rob_count = lsq_count = 0;
+    fetch_group.count = decode_group.count = 0;
+}
+
+// Commit: retire up to `width` finished instructions from the ROB head, in order.
+// Returns true if a store used the memory port.
+static bool commit_stage(void) {
+    bool port_used = false;
+    for (int n = 0; n < width && rob_count; n++) {
+        RobEntry *e = &rob[rob_head];
+        if (!e->done) break;
+        if (e->is_store && port_used) break;  // One store per cycle through the port
+        if (e->fault) {
+            fprintf(stderr, "%s Error: Address %u out of bounds.\n", e->is_store ? "MOVM" : "MOVR", e->address);
+            exit(EXIT_FAILURE);
+        }
+        // Loads report their access at commit, since they may have run speculatively
+        if (e->is_load) HOOK(HOOK_MEMORY_ACCESS, .pc = e->pc, .location = e->address, .value = e->value);
+        if (e->is_store) {
+            HOOK(HOOK_MEMORY_ACCESS, .pc = e->pc, .location = e->address, .value = e->value,
+                 .old_value = memory[e->address], .is_store = true);
+            memory_write(e->address, e->value);
+            port_used = true;
+            TRACE("[COMMIT] [%u] MOVM: Stored %d into memory[%u]\n", e->pc, (int32_t)e->value, e->address);
+        } else if (writes_register(&e->decoded)) {
+            HOOK(HOOK_REGISTER_WRITE, .pc = e->pc, .location = e->decoded.r1, .value = e->value,
+                 .old_value = registers[e->decoded.r1]);
+            registers[e->decoded.r1] = e->value;
+            if (rat[e->decoded.r1] == rob_head) rat[e->decoded.r1] = NO_TAG;
+            TRACE("[COMMIT] [%u] Wrote %d to R%d\n", e->pc, (int32_t)e->value, e->decoded.r1);
+        } else {
+            TRACE("[COMMIT] [%u] Opcode %d\n", e->pc, e->decoded.opcode);
+        }
+        if (e->is_load || e->is_store) lsq_count--;
+        instructions_executed++;
+        HOOK(HOOK_RETIRE, .pc = e->pc, .instruction = instruction_memory[e->pc]);
+        bool flush = e->taken;
+        uint32_t target = e->target;
+        e->busy = false;
+        rob_head = rob_index(1);
+        rob_count--;
+
+        if (flush) {
+            // Mispredicted JEQ: everything younger is on the wrong path
+            HOOK(HOOK_FLUSH, .pc = e->pc, .instruction = instruction_memory[e->pc], .value = target);
+            TRACE("[FLUSH] JEQ taken. Squashing %d younger instructions. Old PC: %u, New PC: %u\n", rob_count, PC, target);
+            reset_ooo();
+            PC = target;
+            mispredicts++;
+            flush_count++;
+            break;
+        }
+    }
+    return port_used;
+}
+
+// Load/store queue: the oldest load that can proceed either takes its value from
+// an older store or reads memory through the port. Returns true if it used the port.
+static bool memory_stage(bool port_busy) {
+    for (int n = 0; n < rob_count; n++) {
+        int idx = rob_index(n);
+        RobEntry *load = &rob[idx];
+        if (!load->is_load || !load->mem_pending) continue;
+
+        // Disambiguation: search older stores, youngest first
+        bool blocked = false;
+        int forward_from = NO_TAG;
+        for (int m = n - 1; m >= 0; m--) {
+            RobEntry *older = &rob[rob_index(m)];
+            if (!older->is_store) continue;
+            if (!older->addr_ready) {
+                blocked = true;
+                break;
+            }
+            if (older->address == load->address) {
+                // Forward once the store data is on the bus
+                if (!older->done) blocked = true;
+                else forward_from = rob_index(m);
+                break;
+            }
+        }
+        if (blocked) {
+            loads_blocked++;
+            continue;
+        }
+        if (forward_from != NO_TAG) {
+            load->value = rob[forward_from].value;
+            loads_forwarded++;
+            TRACE("[LSQ] [%u] MOVR: Forwarded %d from store [%u]\n", load->pc, (int32_t)load->value, rob[forward_from].pc);
+        } else if (port_busy) {
+            continue;
+        } else {
+            load->value = memory[load->address];
+            TRACE("[LSQ] [%u] MOVR: Read %d from memory[%u]\n", load->pc, (int32_t)load->value, load->address);
+        }
+        load->mem_pending = false;
+        load->done = true;
+        broadcast(idx, load->value);
+        return forward_from == NO_TAG;
+    }
+    return false;
+}
+
+// Execute: finish stations whose 2 EX cycles are up, then issue ready ones out of order
+static void execute_stage(void) {
+    for (int i = 0; i < OOO_RS_SIZE; i++) {
+        RsEntry *s = &rs[i];
+        if (!s->busy || !s->issued) continue;
+        if (s->awaiting_data) {
+            if (s->qk != NO_TAG) continue;
+            rob[s->rob].value = s->vk;
+            rob[s->rob].done = true;
+            s->busy = false;
+            continue;
+        }
+        if (--s->cycles_remaining > 0) continue;
+        RobEntry *e = &rob[s->rob];
+        switch (e->decoded.opcode) {
+            case 7: // JEQ
+                e->taken = (s->vj == s->vk);
+                e->target = e->pc + e->decoded.imm;
+                e->done = true;
+                break;
+            case 9: // MOVR: address now known, value comes from the LSQ
+                e->address = s->vj + e->decoded.imm;
+                e->addr_ready = true;
+                if (e->address >= MEMORY_SIZE) {
+                    e->fault = true;
+                    e->done = true;
+                } else {
+                    e->mem_pending = true;
+                }
+                break;
+            case 10: // MOVM: address and data wait in the ROB until commit
+                e->address = s->vj + e->decoded.imm;
+                e->addr_ready = true;
+                e->fault = e->address >= MEMORY_SIZE;
+                if (s->qk != NO_TAG) {
+                    // Address known early for disambiguation; the data follows on the bus
+                    s->awaiting_data = true;
+                    continue;
+                }
+                e->value = s->vk;
+                e->done = true;
+                break;
+            default:
+                e->value = alu_result(&e->decoded, s->vj, s->vk);
+                e->done = true;
+                broadcast(s->rob, e->value);
+                break;
+        }
+        s->busy = false;
+    }
+
+    int issued = 0;
+    // Oldest first, so a full cycle prefers the critical path
+    for (int n = 0; n < rob_count && issued < width; n++) {
+        int idx = rob_index(n);
+        for (int i = 0; i < OOO_RS_SIZE; i++) {
+            RsEntry *s = &rs[i];
+            if (!s->busy || s->issued || s->rob != idx) continue;
+            // A store issues its address as soon as the base register is ready
+            if (s->qj == NO_TAG && (s->qk == NO_TAG || rob[idx].is_store)) {
+                s->issued = true;
+                s->cycles_remaining = 2;
+                issued++;
+            }
+            break;
+        }
+    }
+}
+
+static int free_station(void) {
+    for (int i = 0; i < OOO_RS_SIZE; i++) {
+        if (!rs[i].busy) return i;
+    }
+    return NO_TAG;
+}
+
+// Dispatch: rename and place up to `width` decoded instructions into the ROB and stations
+static void dispatch_stage(void) {
+    if (!decode_group.count || decode_group.cycles_remaining > 0) {
+        cycles_frontend++;
+        return;
+    }
+    int n = 0;
+    while (n < width && n < decode_group.count) {
+        FetchSlot *slot = &decode_group.slot[n];
+        Instruction decoded;
+        instruction_decode(slot->instruction, &decoded);
+        bool is_mem = decoded.opcode == 9 || decoded.opcode == 10;
+        int station = decoded.opcode == 11 ? NO_TAG : free_station();
+
+        bool blocked = true;
+        if (rob_count == OOO_ROB_SIZE) {
+            stalls_rob_full++;
+        } else if (decoded.opcode != 11 && station == NO_TAG) {
+            stalls_rs_full++;
+        } else if (is_mem && lsq_count == OOO_LSQ_SIZE) {
+            stalls_lsq_full++;
+        } else {
+            blocked = false;
+        }
+        if (blocked) {
+            HOOK(HOOK_STALL, .pc = slot->address, .instruction = slot->instruction);
+            break;
+        }
+
+        int idx = rob_index(rob_count++);
+        RobEntry *e = &rob[idx];
+        memset(e, 0, sizeof(*e));
+        e->busy = true;
+        e->pc = slot->address;
+        e->decoded = decoded;
+        e->is_load = decoded.opcode == 9;
+        e->is_store = decoded.opcode == 10;
+        if (is_mem) lsq_count++;
+
+        if (station != NO_TAG) {
+            RsEntry *s = &rs[station];
+            memset(s, 0, sizeof(*s));
+            s->busy = true;
+            s->rob = idx;
+            s->qj = s->qk = NO_TAG;
+            switch (decoded.opcode) {
+                case 0: case 1: case 2: case 3:
+                    read_operand(decoded.r2, &s->vj, &s->qj);
+                    read_operand(decoded.r3, &s->vk, &s->qk);
+                    break;
+                case 4: case 5: case 9:
+                    read_operand(decoded.r2, &s->vj, &s->qj);
+                    break;
+                case 7:
+                    read_operand(decoded.r1, &s->vj, &s->qj);
+                    read_operand(decoded.r2, &s->vk, &s->qk);
+                    break;
+                case 8:
+                    read_operand(decoded.r1, &s->vj, &s->qj);
+                    break;
+                case 10:
+                    read_operand(decoded.r2, &s->vj, &s->qj);
+                    read_operand(decoded.r1, &s->vk, &s->qk);
+                    break;
+                default: // MOVI has no sources
+                    break;
+            }
+        }
+        // Rename after reading sources, so XORI R1 reads the older R1
+        if (writes_register(&decoded)) rat[decoded.r1] = idx;
+        TRACE("[DISPATCH] [%u] 0x%08X -> ROB %d\n", slot->address, slot->instruction, idx);
+        HOOK(HOOK_DECODE, .pc = slot->address, .instruction = slot->instruction);
+        n++;
+
+        if (decoded.opcode == 11) {
+            // JMP target is known at decode: redirect fetch and drop the younger slots
+            e->done = true;
+            PC = decoded.addr;
+            fetch_group.count = 0;
+            decode_group.count = n;
+            TRACE("[REDIRECT] JMP to %u\n", PC);
+            break;
+        }
+    }
+    for (int i = n; i < decode_group.count; i++) decode_group.slot[i - n] = decode_group.slot[i];
+    decode_group.count -= n;
+}
+
+static bool fetch_exhausted(void) {
+    return PC >= (uint32_t)total_instructions || instruction_memory[PC] == 0;
+}
+
+// One clock cycle; returns true once the program has finished
+static bool ooo_cycle(int clock_cycle) {
+    TRACE("\nClock Cycle %d:\n", clock_cycle);
+    rob_occupancy_sum += rob_count;
+    if (rob_count > rob_occupancy_max) rob_occupancy_max = rob_count;
+
+    bool port_busy = commit_stage();
+    port_busy |= memory_stage(port_busy);
+    execute_stage();
+    dispatch_stage();
+
+    // ID to dispatch latch
+    if (decode_group.count && decode_group.cycles_remaining > 0) decode_group.cycles_remaining--;
+    // IF to ID
+    if (fetch_group.count) {
+        if (fetch_group.cycles_remaining > 1) {
+            fetch_group.cycles_remaining--;
+        } else if (!decode_group.count) {
+            decode_group = fetch_group;
+            decode_group.cycles_remaining = 1;
+            fetch_group.count = 0;
+        }
+    }
+    // Fetch a group of sequential instructions when the port is free
+    if (!fetch_group.count && !fetch_exhausted()) {
+        if (port_busy) {
+            fetch_port_conflicts++;
+        } else {
+            int n = 0;
+            while (n < width && !fetch_exhausted()) {
+                fetch_group.slot[n].instruction = instruction_fetch(instruction_memory);
+                fetch_group.slot[n].address = PC;
+                instructions_fetched++;
+                PC++;
+                n++;
+            }
+            fetch_group.count = n;
+            fetch_group.cycles_remaining = 2;
+        }
+    }
+
+    TRACE("ROB: %d entries, LSQ: %d, PC: %u\n", rob_count, lsq_count, PC);
+    return !rob_count && !fetch_group.count && !decode_group.count && fetch_exhausted();
+}
+
+int run_ooo(int issue_width, long max_cycles) {
+    if (issue_width < 1) issue_width = 1;
+    if (issue_width > MAX_ISSUE_WIDTH) issue_width = MAX_ISSUE_WIDTH;
+    width = issue_width;
+    reset_ooo();
+
+    int clock_cycle = 0;
+    bool terminate = false;
+    while (!terminate) {
+        terminate = ooo_cycle(clock_cycle) || watch_stop_requested;
+        if (!terminate && max_cycles > 0 && clock_cycle > max_cycles) {
+            printf("\n[ERROR] Max cycle count reached. Terminating pipeline.\n");
+            terminate = true;
+        }
+        clock_cycle++;
+    }
+
+    printf("\n======= Out-of-order (width %d, ROB %d, RS %d, LSQ %d) =======\n", width, OOO_ROB_SIZE, OOO_RS_SIZE, OOO_LSQ_SIZE);
+    printf("Clock cycles: %d, Instructions committed: %d, IPC: %.3f\n", clock_cycle, instructions_executed,
+           clock_cycle ? (double)instructions_executed / clock_cycle : 0.0);
+    printf("ROB occupancy: mean %.2f, max %d\n", clock_cycle ? (double)rob_occupancy_sum / clock_cycle : 0.0, rob_occupancy_max);
+    printf("Dispatch stalls: ROB full %ld, RS full %ld, LSQ full %ld; front-end empty %ld cycles\n",
+           stalls_rob_full, stalls_rs_full, stalls_lsq_full, cycles_frontend);
+    printf("Loads: forwarded %ld, waited on older store %ld cycles; fetch blocked by memory port %ld\n",
+           loads_forwarded, loads_blocked, fetch_port_conflicts);
+    printf("JEQ mispredictions: %ld\n", mispredicts);
+    return clock_cycle;
+}
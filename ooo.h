@@ -0,0 +1,30 @@
+#ifndef OOO_H
+#define OOO_H
+
+// Out-of-order core model (Tomasulo with a reorder buffer).
+//
+// IF fetches up to `width` sequential instructions per 2-cycle fetch and ID
+// takes 2 cycles, as in the in-order pipeline. Dispatch renames sources through
+// a register alias table over the 32 architectural registers and places each
+// instruction in the reorder buffer and, except JMP, in a reservation
+// station. Stations issue out of order as soon as their operands are on the
+// common data bus; execution takes 2 cycles. MOVR/MOVM compute their address in
+// EX and then sit in the load/store queue (the memory entries of the ROB):
+// a load waits until every older store address is known, takes its value from
+// the youngest older store to the same address, or else reads memory through
+// the single memory port. Stores write memory when they commit.
+//
+// Commit is in order, so architectural state matches the in-order model. JEQ
+// is predicted not taken and a taken JEQ flushes everything younger when it
+// commits; JMP redirects fetch at dispatch. The memory port is shared as in
+// the in-order pipeline: a fetch cannot start in a cycle that uses memory.
+
+#define OOO_ROB_SIZE 32
+#define OOO_RS_SIZE 16
+#define OOO_LSQ_SIZE 16
+
+// Run the loaded program to completion; max_cycles of 0 means no limit.
+// Returns the number of simulated cycles.
+int run_ooo(int width, long max_cycles);
+
+#endif // OOO_H
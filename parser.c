@@ -45,9 +45,12 @@ uint32_t encode_j_type(int opcode, int address) {
 
 
 void print_binary(uint32_t value) {
+    char bits[33];
     for (int i = 31; i >= 0; i--) {
-        printf("%d", (value >> i) & 1);
+        bits[31 - i] = '0' + ((value >> i) & 1);
     }
+    bits[32] = '\0';
+    printf("%s", bits);
 }
 
 uint32_t parse_instruction(const char *line) {
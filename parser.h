@@ -2,12 +2,13 @@
 #define INSTRUCTION_PARSER_H
 
 #include <stdint.h>
+#include "corelocal.h"
 
 // Maximum number of instructions in the instruction memory
 #define MAX_INSTRUCTIONS 1024
 
 // Instruction memory array declaration (extern for linking)
-extern uint32_t instruction_memory[MAX_INSTRUCTIONS];
+extern CORE_LOCAL uint32_t instruction_memory[MAX_INSTRUCTIONS];
 
 // Function to trim whitespace from a string (returns pointer to trimmed string)
 char *trim_whitespace(char *str);
@@ -6,43 +6,57 @@
 #include "registers.h"
 #include "memory.h"
 #include "funcs.h"
+#include "pipelineRun.h"
+#include "sampling.h"
+#include "checkpoint.h"
+#include "trace.h"
+#include "memo.h"
+#include "multicore.h"
+#include "schedule.h"
+#include "superscalar.h"
+#include "ooo.h"
+#include "storebuffer.h"
+#include "memprofile.h"
+#include "hooks.h"
+#include "watch.h"
 
 #define FILENAME "program.txt"
 #define MAX_INSTRUCTIONS 1024
 #define PIPELINE_DEPTH 4
+#define DEFAULT_MAX_CYCLES 1000
 
-extern uint32_t instruction_memory[MAX_INSTRUCTIONS];
-extern uint32_t PC;
-extern bool flagwork;
-extern int flush_flag;
-extern uint32_t branch_target;
+extern CORE_LOCAL uint32_t instruction_memory[MAX_INSTRUCTIONS];
+extern CORE_LOCAL uint32_t PC;
+extern CORE_LOCAL bool flagwork;
+extern CORE_LOCAL int flush_flag;
+extern CORE_LOCAL uint32_t branch_target;
 
 // --- Add pending flush state ---
-bool pending_flush = false;
-uint32_t branch_flush_target = 0;
-
-// Pipeline stage structures
-typedef struct {
-    uint32_t instruction;
-    Instruction decoded;
-    int cycles_remaining;
-    bool active;
-    uint32_t result; // Separate field for execution result
-    uint32_t instruction_address; // <-- Add this field to track instruction index
-} PipelineStage;
-
-PipelineStage if_stage = {0, {0}, 2, false, 0, 0};
-PipelineStage id_stage = {0, {0}, 2, false, 0, 0};
-PipelineStage ex_stage = {0, {0}, 2, false, 0, 0};
-PipelineStage mem_stage = {0, {0}, 1, false, 0, 0};
-PipelineStage wb_stage = {0, {0}, 1, false, 0, 0};
-
-int total_instructions = 0;
-int instructions_fetched = 0; // Track number of instructions fetched
-int instructions_executed = 0; // Track number of instructions completed
+CORE_LOCAL bool pending_flush = false;
+CORE_LOCAL uint32_t branch_flush_target = 0;
+CORE_LOCAL uint32_t branch_flush_pc = 0;          // Address of the taken branch that owns pending_flush
+CORE_LOCAL uint32_t branch_flush_trace_index = 0; // Its trace position (replay mode)
+
+CORE_LOCAL PipelineStage if_stage = {0, {0}, 2, false, 0, 0, 0};
+CORE_LOCAL PipelineStage id_stage = {0, {0}, 2, false, 0, 0, 0};
+CORE_LOCAL PipelineStage ex_stage = {0, {0}, 2, false, 0, 0, 0};
+CORE_LOCAL PipelineStage mem_stage = {0, {0}, 1, false, 0, 0, 0};
+CORE_LOCAL PipelineStage wb_stage = {0, {0}, 1, false, 0, 0, 0};
+
+CORE_LOCAL int total_instructions = 0;
+CORE_LOCAL int instructions_fetched = 0; // Track number of instructions fetched
+CORE_LOCAL int instructions_executed = 0; // Track number of instructions completed
+CORE_LOCAL bool fetch_enabled = true;
+CORE_LOCAL int flush_count = 0;
+
+// Effective MOVR/MOVM address of the instruction held in a stage (recorded address when replaying)
+static uint32_t stage_mem_address(PipelineStage *stage, Instruction *instr) {
+    if (replay_active) return trace_records[stage->trace_index].mem_address;
+    return registers[instr->r2] + instr->imm;
+}
 
 // Helper function to check for data hazards (RAW)
-bool has_data_hazard(Instruction *curr, PipelineStage *ex, PipelineStage *mem, PipelineStage *wb) {
+bool has_data_hazard(Instruction *curr, PipelineStage *id, PipelineStage *ex, PipelineStage *mem, PipelineStage *wb) {
     if (!curr) return false;
     // Source registers for the current instruction
     uint8_t src_regs[3] = {0, 0, 0};
@@ -90,17 +104,18 @@ bool has_data_hazard(Instruction *curr, PipelineStage *ex, PipelineStage *mem, P
         }
     }
     // Special case: MOVM->MOVR memory hazard (check both EX and MEM stages)
-    if (curr->opcode == 9) { // MOVR in ID
+    // A store buffer forwards the MOVM's value instead, so the MOVR need not wait
+    if (curr->opcode == 9 && !store_buffer_enabled) { // MOVR in ID
         if (ex->active && ex->decoded.opcode == 10) {
-            uint32_t movm_addr = registers[ex->decoded.r2] + ex->decoded.imm;
-            uint32_t movr_addr = registers[curr->r2] + curr->imm;
+            uint32_t movm_addr = stage_mem_address(ex, &ex->decoded);
+            uint32_t movr_addr = stage_mem_address(id, curr);
             if (movm_addr == movr_addr) {
                 return true;
             }
         }
         if (mem->active && mem->decoded.opcode == 10) {
-            uint32_t movm_addr = registers[mem->decoded.r2] + mem->decoded.imm;
-            uint32_t movr_addr = registers[curr->r2] + curr->imm;
+            uint32_t movm_addr = stage_mem_address(mem, &mem->decoded);
+            uint32_t movr_addr = stage_mem_address(id, curr);
             if (movm_addr == movr_addr) {
                 return true;
             }
@@ -128,18 +143,18 @@ bool has_data_hazard(Instruction *curr, PipelineStage *ex, PipelineStage *mem, P
 }
 
 void print_pipeline_state(int cycle) {
-    printf("\nClock Cycle %d State:\n", cycle);
-    printf("IF: %s (Cycles: %d, Instr: 0x%08X)\n", 
+    TRACE("\nClock Cycle %d State:\n", cycle);
+    TRACE("IF: %s (Cycles: %d, Instr: 0x%08X)\n", 
            if_stage.active ? "Active" : "Inactive", if_stage.cycles_remaining, if_stage.instruction);
-    printf("ID: %s (Cycles: %d, Instr: 0x%08X)\n", 
+    TRACE("ID: %s (Cycles: %d, Instr: 0x%08X)\n", 
            id_stage.active ? "Active" : "Inactive", id_stage.cycles_remaining, id_stage.instruction);
-    printf("EX: %s (Cycles: %d, Result: %u)\n", 
+    TRACE("EX: %s (Cycles: %d, Result: %u)\n", 
            ex_stage.active ? "Active" : "Inactive", ex_stage.cycles_remaining, ex_stage.result);
-    printf("MEM: %s (Cycles: %d, Result: %u)\n", 
+    TRACE("MEM: %s (Cycles: %d, Result: %u)\n", 
            mem_stage.active ? "Active" : "Inactive", mem_stage.cycles_remaining, mem_stage.result);
-    printf("WB: %s (Cycles: %d, Result: %u)\n", 
+    TRACE("WB: %s (Cycles: %d, Result: %u)\n", 
            wb_stage.active ? "Active" : "Inactive", wb_stage.cycles_remaining, wb_stage.result);
-    printf("PC: %d, Flush Flag: %d, Branch Target: %d\n", PC, flush_flag, branch_target);
+    TRACE("PC: %d, Flush Flag: %d, Branch Target: %d\n", PC, flush_flag, branch_target);
 }
 
 void flush_pipeline() {
@@ -167,7 +182,7 @@ void flush_pipeline() {
     PC = branch_target;
     if (PC >= total_instructions) PC = total_instructions - 1;
     flush_flag = 0;
-    printf("[FLUSH] Pipeline flushed. Old PC: %u, New PC: %u (Branch Target: %u)\n", old_pc, PC, branch_target);
+    TRACE("[FLUSH] Pipeline flushed. Old PC: %u, New PC: %u (Branch Target: %u)\n", old_pc, PC, branch_target);
 }
 
 void flush_pipeline_after_wb() {
@@ -189,11 +204,16 @@ void flush_pipeline_after_wb() {
     mem_stage.result = 0;
     wb_stage.result = 0;
 
+    // Replay refetches from the record after the branch, like PC does below
+    if (replay_active) replay_cursor = wb_stage.trace_index + 1;
+
+    HOOK(HOOK_FLUSH, .pc = wb_stage.instruction_address, .instruction = wb_stage.instruction, .value = branch_flush_target);
     uint32_t old_pc = PC;
     PC = branch_flush_target;
     pending_flush = false;
+    flush_count++;
     flush_flag = 0;
-    printf("[FLUSH] Pipeline flushed after WB. Old PC: %u, New PC: %u (Branch Target: %u)\n", old_pc, PC, branch_flush_target);
+    TRACE("[FLUSH] Pipeline flushed after WB. Old PC: %u, New PC: %u (Branch Target: %u)\n", old_pc, PC, branch_flush_target);
 }
 
 void terminate_pipeline() {
@@ -209,20 +229,229 @@ void terminate_pipeline() {
     wb_stage.result = 0;
 }
 
-int main() {
-    init_memory();
-    init_registers();
+void reset_pipeline() {
+    terminate_pipeline();
+    if_stage.cycles_remaining = 2;
+    id_stage.cycles_remaining = 2;
+    ex_stage.cycles_remaining = 2;
+    mem_stage.cycles_remaining = 1;
+    wb_stage.cycles_remaining = 1;
+    pending_flush = false;
+    flush_flag = 0;
+}
+
+// IF waits while MEM holds an instruction, except a MOVM going to the store buffer
+static bool mem_blocks_fetch(void) {
+    return mem_stage.active && !(store_buffer_enabled && mem_stage.decoded.opcode == 10);
+}
+
+bool pipeline_is_empty() {
+    return !if_stage.active && !id_stage.active && !ex_stage.active && !mem_stage.active && !wb_stage.active;
+}
+
+bool pipeline_cycle(int clock_cycle) {
+    bool stall = false; // Add stall flag
+
+    TRACE("\nClock Cycle %d:\n", clock_cycle);
+
+    // Write Back Stage
+    if (wb_stage.active && wb_stage.cycles_remaining == 1) {
+        HOOK_SET_PC(wb_stage.instruction_address);
+        if (!replay_active) write_back(&wb_stage.decoded, wb_stage.result);
+        wb_stage.cycles_remaining--;
+        wb_stage.active = false;
+        instructions_executed++; // Increment after WB completes
+        HOOK(HOOK_RETIRE, .pc = wb_stage.instruction_address, .instruction = wb_stage.instruction);
+        // --- Flush only when the taken branch itself retires; an older instruction held in MEM may retire first ---
+        // Outside replay the PC is enough: reaching it again takes a taken branch, which flushes first
+        if (pending_flush && wb_stage.instruction_address == branch_flush_pc &&
+            (!replay_active || wb_stage.trace_index == branch_flush_trace_index)) {
+            flush_pipeline_after_wb();
+            // Nothing else uses the port in a flush cycle
+            if (store_buffer_enabled) store_buffer_drain();
+            // After flush, skip rest of this cycle to avoid fetching/advancing pipeline in same cycle
+            print_pipeline_state(clock_cycle);
+            return false;
+        }
+    }
+
+    // Memory Stage (MOVR/MOVM need the shared memory port)
+    bool mem_uses_port = mem_stage.decoded.opcode == 9 || (mem_stage.decoded.opcode == 10 && !store_buffer_enabled);
+    bool port_busy = false; // Store buffer: the port was used this cycle
+    bool mem_ready = mem_stage.active && mem_stage.cycles_remaining == 1;
+    if (mem_ready && store_buffer_enabled && mem_stage.decoded.opcode == 10 && store_buffer_full()) {
+        // No free entry: the oldest store takes the port and the MOVM waits a cycle
+        store_buffer_drain();
+        store_buffer_full_stalls++;
+        port_busy = true;
+        mem_ready = false;
+        TRACE("[STALL] Store buffer full. MOVM waits in MEM.\n");
+        HOOK(HOOK_STALL, .pc = mem_stage.instruction_address, .instruction = mem_stage.instruction);
+    }
+    if (mem_ready && (!mem_uses_port || memory_port_granted(clock_cycle, false))) {
+        long forwards_before = store_buffer_forwards;
+        if (mem_profile_enabled && (mem_stage.decoded.opcode == 9 || mem_stage.decoded.opcode == 10)) {
+            mem_profile_record(mem_stage.instruction_address, stage_mem_address(&mem_stage, &mem_stage.decoded),
+                               mem_stage.decoded.opcode == 10);
+        }
+        HOOK_SET_PC(mem_stage.instruction_address);
+        if (!replay_active) memory_access(memory, &mem_stage.decoded);
+        if (store_buffer_enabled && mem_stage.decoded.opcode == 9 && store_buffer_forwards == forwards_before) port_busy = true;
+        mem_stage.cycles_remaining--;
+        if (!wb_stage.active) {
+            if (mem_stage.decoded.opcode == 9 && !replay_active) { // MOVR
+                extern CORE_LOCAL uint32_t finalResult;
+                mem_stage.result = finalResult; // Value loaded from memory
+                TRACE("MOVR: Read value %u from memory[%d]\n", finalResult, registers[mem_stage.decoded.r2] + mem_stage.decoded.imm);
+            }
+            wb_stage.instruction = mem_stage.instruction;
+            wb_stage.instruction_address = mem_stage.instruction_address; // propagate address
+            wb_stage.trace_index = mem_stage.trace_index;
+            wb_stage.decoded = mem_stage.decoded;
+            wb_stage.result = mem_stage.result;
+            wb_stage.cycles_remaining = 1;
+            wb_stage.active = true;
+            mem_stage.active = false;
+        }
+    }
 
-    FILE *file = fopen(FILENAME, "r");
+    // Execute Stage
+    if (ex_stage.active) {
+        if (ex_stage.cycles_remaining == 1) {
+            if (replay_active) {
+                ex_stage.result = replay_execute(&ex_stage);
+            } else {
+                ex_stage.result = execute(&ex_stage.decoded, ex_stage.instruction_address); // pass correct address
+                if (memo_enabled) memo_note_execute(&ex_stage);
+            }
+            ex_stage.cycles_remaining--;
+            // --- Branch/Jump logic: set pending flush if needed ---
+            if (flush_flag) {
+                pending_flush = true;
+                branch_flush_target = branch_target;
+                branch_flush_pc = ex_stage.instruction_address;
+                branch_flush_trace_index = ex_stage.trace_index;
+                // Do NOT flush now; wait until WB of this instruction
+            }
+        } else if (ex_stage.cycles_remaining > 1) {
+            ex_stage.cycles_remaining--;
+        }
+        // Executed instructions hold at 0 until MEM frees up
+        if (ex_stage.cycles_remaining == 0 && !mem_stage.active) {
+            mem_stage.instruction = ex_stage.instruction;
+            mem_stage.instruction_address = ex_stage.instruction_address; // propagate address
+            mem_stage.trace_index = ex_stage.trace_index;
+            mem_stage.decoded = ex_stage.decoded;
+            mem_stage.result = ex_stage.result;
+            mem_stage.cycles_remaining = 1;
+            mem_stage.active = true;
+            ex_stage.active = false;
+        }
+    }
+
+    // Data Hazard Detection (stall logic)
+    Instruction temp_decoded = {0};
+    if (id_stage.active && id_stage.cycles_remaining == 1) {
+        // Decode instruction to check hazard
+        instruction_decode(id_stage.instruction, &temp_decoded);
+        if (has_data_hazard(&temp_decoded, &id_stage, &ex_stage, &mem_stage, &wb_stage)) {
+            stall = true;
+            TRACE("[STALL] Data hazard detected. Stalling pipeline.\n");
+            HOOK(HOOK_STALL, .pc = id_stage.instruction_address, .instruction = id_stage.instruction);
+        }
+    }
+    // Decode Stage
+    if (id_stage.active) {
+        instruction_decode(id_stage.instruction, &id_stage.decoded);
+        if (id_stage.cycles_remaining == 1 && !stall) {
+            id_stage.cycles_remaining--;
+            if (!ex_stage.active) {
+                ex_stage.instruction = id_stage.instruction;
+                ex_stage.instruction_address = id_stage.instruction_address; // propagate address
+                ex_stage.trace_index = id_stage.trace_index;
+                ex_stage.decoded = id_stage.decoded;
+                HOOK(HOOK_DECODE, .pc = id_stage.instruction_address, .instruction = id_stage.instruction);
+                ex_stage.result = 0;
+                ex_stage.cycles_remaining = 2;
+                ex_stage.active = true;
+                id_stage.active = false;
+            }
+        } else if (!stall) {
+            id_stage.cycles_remaining--;
+        }
+    }
+
+    // Fetch Stage
+    // Only allow IF if MEM is not active this cycle
+    // When replaying, the next instruction comes from the recorded stream instead of memory
+    bool can_fetch = replay_active ? replay_cursor < trace_length
+                                   : flagwork && PC < total_instructions && instruction_memory[PC] != 0;
+    if (fetch_enabled && can_fetch && !stall && !flush_flag && !mem_blocks_fetch() && !port_busy &&
+        !if_stage.active && memory_port_granted(clock_cycle, true)) {
+        port_busy = true;
+        if (!if_stage.active && replay_active) {
+            const TraceRecord *record = &trace_records[replay_cursor];
+            if_stage.instruction = record->instruction;
+            if_stage.instruction_address = record->pc;
+            if_stage.trace_index = replay_cursor++;
+            if_stage.cycles_remaining = 2;
+            if_stage.active = true;
+            instructions_fetched++;
+            PC = record->pc + 1;
+            TRACE("Fetch Stage (replay): Record %u at address %u => 0x%08X\n", if_stage.trace_index, record->pc, record->instruction);
+        } else if (!if_stage.active) {
+            if_stage.instruction = instruction_fetch(instruction_memory);
+            if_stage.instruction_address = PC; // Store the address before incrementing PC
+            if_stage.cycles_remaining = 2;
+            if_stage.active = true;
+            instructions_fetched++;
+            PC++; // PC is incremented here after a successful fetch
+        }
+    }
+    // IF to ID progression (only if not stalling and MEM is not active)
+    if (if_stage.active && if_stage.cycles_remaining == 1 && !stall && !mem_blocks_fetch()) {
+        if_stage.cycles_remaining--;
+        if (!id_stage.active) {
+            id_stage.instruction = if_stage.instruction;
+            id_stage.instruction_address = if_stage.instruction_address; // propagate address
+            id_stage.trace_index = if_stage.trace_index;
+            id_stage.cycles_remaining = 2;
+            id_stage.active = true;
+            if_stage.active = false;
+        }
+    } else if (if_stage.active && !stall && !mem_blocks_fetch()) {
+        if_stage.cycles_remaining--;
+    }
+    // Retire one buffered store whenever nothing else needed the port
+    if (store_buffer_enabled && !port_busy) store_buffer_drain();
+    // If stalling, or if MEM is active, IF and ID hold their state (do not decrement cycles_remaining)
+
+    print_pipeline_state(clock_cycle);
+
+    // Exit condition
+    // Stop fetching new instructions once all have been fetched, but let pipeline drain.
+    // Decided by PC rather than by a fetch count: with loops, or while IF waits for the
+    // shared memory port, the pipeline can be empty before the program is finished.
+    bool all_fetched = replay_active ? replay_cursor >= trace_length
+                                     : (PC >= total_instructions || instruction_memory[PC] == 0);
+    if (pipeline_is_empty() && all_fetched && store_buffer_count == 0) {
+        terminate_pipeline();
+        return true;
+    }
+    return false;
+}
+
+int load_program(const char *filename) {
+    FILE *file = fopen(filename, "r");
     if (!file) {
         perror("Error opening file");
-        return EXIT_FAILURE;
+        return -1;
     }
 
     char buffer[256];
     int instruction_index = 0;
 
-    printf("Reading file: %s\n\n", FILENAME);
+    TRACE("Reading file: %s\n\n", filename);
 
     while (fgets(buffer, sizeof(buffer), file) && instruction_index < MAX_INSTRUCTIONS) {
         char *line = trim_whitespace(buffer);
@@ -231,162 +460,308 @@ int main() {
         uint32_t encoded = parse_instruction(line);
         instruction_memory[instruction_index++] = encoded;
 
-        printf("Instruction %d encoded as: ", instruction_index);
-        print_binary(encoded);
-        printf("\n");
+        TRACE("Instruction %d encoded as: ", instruction_index);
+        if (trace_enabled) print_binary(encoded);
+        TRACE("\n");
     }
 
     fclose(file);
-    write_instruction_memory(instruction_memory);
 
-    int clock_cycle = 0;
     total_instructions = instruction_index; // Dynamically set based on file input (11 in your case)
-    bool terminate = false;
-    bool stall = false; // Add stall flag
+    return 0;
+}
 
-    while (!terminate) {
-        printf("\nClock Cycle %d:\n", clock_cycle);
-
-        // Write Back Stage
-        if (wb_stage.active && wb_stage.cycles_remaining == 1) {
-            write_back(&wb_stage.decoded, wb_stage.result);
-            wb_stage.cycles_remaining--;
-            wb_stage.active = false;
-            instructions_executed++; // Increment after WB completes
-            // --- If a flush is pending, flush pipeline after WB ---
-            if (pending_flush) {
-                flush_pipeline_after_wb();
-                // After flush, skip rest of this cycle to avoid fetching/advancing pipeline in same cycle
-                print_pipeline_state(clock_cycle);
-                clock_cycle++;
-                continue;
-            }
-        }
+// The benchmark harness (bench/bench.c) links this file with -DPIPELINE_NO_MAIN
+#ifndef PIPELINE_NO_MAIN
+// End-of-run memory delta, image save and comparison; returns the exit status
+static int finish_memory_reports(long mem_delta_interval, const char *delta_label, const char *save_path,
+                                 const char *compare_path) {
+    if (mem_delta_interval >= 0) memory_delta_report(delta_label);
+    if (save_path && save_memory_image(save_path) != 0) return EXIT_FAILURE;
+    if (compare_path && compare_memory_image(compare_path) != 0) return EXIT_FAILURE;
+    return EXIT_SUCCESS;
+}
 
-        // Memory Stage
-        if (mem_stage.active && mem_stage.cycles_remaining == 1) {
-            memory_access(memory, &mem_stage.decoded);
-            mem_stage.cycles_remaining--;
-            if (!wb_stage.active) {
-                if (mem_stage.decoded.opcode == 9) { // MOVR
-                    extern uint32_t finalResult;
-                    mem_stage.result = finalResult; // Value loaded from memory
-                    printf("MOVR: Read value %u from memory[%d]\n", finalResult, registers[mem_stage.decoded.r2] + mem_stage.decoded.imm);
-                }
-                wb_stage.instruction = mem_stage.instruction;
-                wb_stage.instruction_address = mem_stage.instruction_address; // propagate address
-                wb_stage.decoded = mem_stage.decoded;
-                wb_stage.result = mem_stage.result;
-                wb_stage.cycles_remaining = 1;
-                wb_stage.active = true;
-                mem_stage.active = false;
+static void print_usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [program.txt] [--quiet] [--sample INTERVAL WARMUP MEASURE]\n"
+                    "       [--checkpoint-cycle N FILE | --checkpoint-pc PC FILE] [--restore FILE]\n"
+                    "       [--record FILE | --replay FILE] [--memo] [--max-cycles N] [--schedule]\n"
+                    "       [--issue-width W | --ooo W] [--store-buffer N] [--mem-profile]\n"
+                    "       [--mem-delta N] [--save-memory FILE] [--compare-memory FILE]\n"
+                    "       [--watch-reg R] [--watch-mem ADDR] [--break-pc PC]\n"
+                    "       [--cores N [--quantum Q] [program.txt ...]]\n", prog);
+}
+
+int main(int argc, char *argv[]) {
+    const char *filename = FILENAME;
+    bool sampled = false;
+    SampleConfig sample_config = {0};
+    const char *checkpoint_path = NULL;
+    long checkpoint_cycle = -1;
+    long checkpoint_pc = -1;
+    const char *restore_path = NULL;
+    const char *record_path = NULL;
+    const char *replay_path = NULL;
+    long max_cycles = DEFAULT_MAX_CYCLES; // 0 means no limit
+    int core_count = 0; // 0 selects the single-core simulator
+    int issue_width = 0; // 0 selects the scalar pipeline
+    int ooo_width = 0; // 0 selects the in-order models
+    int quantum = DEFAULT_QUANTUM;
+    long mem_delta_interval = -1; // -1 no delta report, 0 one for the whole run, N every N cycles
+    const char *save_memory_path = NULL;
+    const char *compare_memory_path = NULL;
+    bool watching = false;
+    bool breaking = false;
+    const char *programs[MAX_CORES];
+    int program_count = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--quiet") == 0) {
+            trace_enabled = false;
+        } else if (strcmp(argv[i], "--sample") == 0 && i + 3 < argc) {
+            sampled = true;
+            sample_config.interval = strtoull(argv[++i], NULL, 10);
+            sample_config.warmup = strtoull(argv[++i], NULL, 10);
+            sample_config.measure = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--checkpoint-cycle") == 0 && i + 2 < argc) {
+            checkpoint_cycle = strtol(argv[++i], NULL, 10);
+            checkpoint_path = argv[++i];
+        } else if (strcmp(argv[i], "--checkpoint-pc") == 0 && i + 2 < argc) {
+            checkpoint_pc = strtol(argv[++i], NULL, 10);
+            checkpoint_path = argv[++i];
+        } else if (strcmp(argv[i], "--restore") == 0 && i + 1 < argc) {
+            restore_path = argv[++i];
+        } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            record_path = argv[++i];
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replay_path = argv[++i];
+        } else if (strcmp(argv[i], "--memo") == 0) {
+            memo_enabled = true;
+        } else if (strcmp(argv[i], "--max-cycles") == 0 && i + 1 < argc) {
+            max_cycles = strtol(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--schedule") == 0) {
+            schedule_enabled = true;
+        } else if (strcmp(argv[i], "--issue-width") == 0 && i + 1 < argc) {
+            issue_width = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--ooo") == 0 && i + 1 < argc) {
+            ooo_width = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--store-buffer") == 0 && i + 1 < argc) {
+            store_buffer_enabled = true;
+            store_buffer_capacity = atoi(argv[++i]);
+            if (store_buffer_capacity < 1 || store_buffer_capacity > MAX_STORE_BUFFER_ENTRIES) {
+                fprintf(stderr, "--store-buffer takes 1 to %d entries\n", MAX_STORE_BUFFER_ENTRIES);
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(argv[i], "--mem-profile") == 0) {
+            mem_profile_enabled = true;
+        } else if (strcmp(argv[i], "--mem-delta") == 0 && i + 1 < argc) {
+            mem_delta_interval = strtol(argv[++i], NULL, 10);
+            if (mem_delta_interval < 0) mem_delta_interval = 0;
+        } else if (strcmp(argv[i], "--save-memory") == 0 && i + 1 < argc) {
+            save_memory_path = argv[++i];
+        } else if (strcmp(argv[i], "--compare-memory") == 0 && i + 1 < argc) {
+            compare_memory_path = argv[++i];
+        } else if (strcmp(argv[i], "--watch-reg") == 0 && i + 1 < argc) {
+            const char *reg = argv[++i];
+            if (reg[0] == 'R' || reg[0] == 'r') reg++;
+            if (watch_register(atoi(reg)) != 0) {
+                fprintf(stderr, "Cannot watch register %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+            watching = true;
+        } else if (strcmp(argv[i], "--watch-mem") == 0 && i + 1 < argc) {
+            if (watch_memory(strtoul(argv[++i], NULL, 0)) != 0) {
+                fprintf(stderr, "Cannot watch memory address %s\n", argv[i]);
+                return EXIT_FAILURE;
             }
+            watching = true;
+        } else if (strcmp(argv[i], "--break-pc") == 0 && i + 1 < argc) {
+            if (break_at_pc(strtoul(argv[++i], NULL, 0)) != 0) {
+                fprintf(stderr, "Cannot set a breakpoint at %s\n", argv[i]);
+                return EXIT_FAILURE;
+            }
+            breaking = true;
+        } else if (strcmp(argv[i], "--cores") == 0 && i + 1 < argc) {
+            core_count = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--quantum") == 0 && i + 1 < argc) {
+            quantum = atoi(argv[++i]);
+        } else if (argv[i][0] != '-') {
+            filename = argv[i];
+            if (program_count < MAX_CORES) programs[program_count++] = argv[i];
+        } else {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
         }
+    }
 
-        // Execute Stage
-        if (ex_stage.active) {
-            if (ex_stage.cycles_remaining == 1) {
-                ex_stage.result = execute(&ex_stage.decoded, ex_stage.instruction_address); // pass correct address
-                ex_stage.cycles_remaining--;
-                // --- Branch/Jump logic: set pending flush if needed ---
-                if (flush_flag) {
-                    pending_flush = true;
-                    branch_flush_target = branch_target;
-                    // Do NOT flush now; wait until WB of this instruction
-                }
-                if (!mem_stage.active && !terminate) {
-                    mem_stage.instruction = ex_stage.instruction;
-                    mem_stage.instruction_address = ex_stage.instruction_address; // propagate address
-                    mem_stage.decoded = ex_stage.decoded;
-                    mem_stage.result = ex_stage.result;
-                    mem_stage.cycles_remaining = 1;
-                    mem_stage.active = true;
-                    ex_stage.active = false;
-                }
-            } else {
-                ex_stage.cycles_remaining--;
-            }
+    init_memory();
+    init_registers();
+
+    int clock_cycle = 0;
+    if (replay_path) {
+        // Timing-only run: the trace supplies instructions, addresses and branch outcomes
+        if (load_trace(replay_path) != 0) {
+            return EXIT_FAILURE;
+        }
+    } else if (restore_path) {
+        // The checkpoint carries the program itself, so no source file is parsed
+        if (load_checkpoint(restore_path, &clock_cycle) != 0) {
+            return EXIT_FAILURE;
         }
+    } else if (core_count > 0) {
+        // Each core thread parses its own program into its private instruction memory
+    } else if (load_program(filename) != 0) {
+        return EXIT_FAILURE;
+    } else {
+        if (schedule_enabled) schedule_program(instruction_memory, total_instructions);
+        write_instruction_memory(instruction_memory);
+        // Deltas describe what the program wrote, not its own image
+        memory_delta_reset();
+    }
 
-        // Data Hazard Detection (stall logic)
-        stall = false;
-        Instruction temp_decoded = {0};
-        if (id_stage.active && id_stage.cycles_remaining == 1) {
-            // Decode instruction to check hazard
-            instruction_decode(id_stage.instruction, &temp_decoded);
-            if (has_data_hazard(&temp_decoded, &ex_stage, &mem_stage, &wb_stage)) {
-                stall = true;
-                printf("[STALL] Data hazard detected. Stalling pipeline.\n");
-            }
+    if (store_buffer_enabled && (core_count > 0 || issue_width > 0 || ooo_width > 0 || sampled || record_path ||
+                                 replay_active || restore_path || checkpoint_path || memo_enabled)) {
+        fprintf(stderr, "--store-buffer only models the scalar pipeline and does not support sampling, traces, checkpoints or --memo\n");
+        return EXIT_FAILURE;
+    }
+
+    // The profiler hooks the scalar pipeline's MEM stage, so every access must go through it
+    // --schedule replays trial blocks on the scalar pipeline, which the profile would count as well
+    if (mem_profile_enabled && (core_count > 0 || issue_width > 0 || ooo_width > 0 || sampled || record_path || memo_enabled ||
+                                schedule_enabled)) {
+        fprintf(stderr, "--mem-profile only profiles the scalar pipeline and does not support sampling, --record, --memo or --schedule\n");
+        return EXIT_FAILURE;
+    }
+
+    // The trace stands in for the program: there is nothing to sample, record, restore or schedule
+    if (replay_path && (sampled || record_path || restore_path || schedule_enabled)) {
+        fprintf(stderr, "--replay does not support sampling, --record, --restore or --schedule\n");
+        return EXIT_FAILURE;
+    }
+
+    if (replay_active && (mem_delta_interval >= 0 || save_memory_path || compare_memory_path)) {
+        fprintf(stderr, "A replay carries no data, so --mem-delta, --save-memory and --compare-memory do not apply\n");
+        return EXIT_FAILURE;
+    }
+
+    // Memo would report the writes of segments it later undoes; breakpoints are checked by the detailed loops only
+    if ((watching || breaking) && (core_count > 0 || memo_enabled)) {
+        fprintf(stderr, "Watchpoints and breakpoints do not support --cores or --memo\n");
+        return EXIT_FAILURE;
+    }
+    // Undone memo segments still leave their words marked as written
+    if (memo_enabled && mem_delta_interval >= 0) {
+        fprintf(stderr, "--mem-delta does not support --memo\n");
+        return EXIT_FAILURE;
+    }
+    if (breaking && (sampled || record_path)) {
+        fprintf(stderr, "Breakpoints do not support sampling or --record\n");
+        return EXIT_FAILURE;
+    }
+
+    if (core_count > 0) {
+        if (sampled || record_path || replay_path || restore_path || checkpoint_path || memo_enabled || schedule_enabled) {
+            fprintf(stderr, "Multicore runs do not support sampling, traces, checkpoints, --memo or --schedule\n");
+            return EXIT_FAILURE;
+        }
+        // Per-cycle traces from several threads would interleave unpredictably
+        trace_enabled = false;
+        if (program_count == 0) programs[program_count++] = filename;
+        if (run_multicore(programs, program_count, core_count, quantum, max_cycles) != 0) {
+            return EXIT_FAILURE;
+        }
+        print_memory();
+        return finish_memory_reports(mem_delta_interval, "whole run", save_memory_path, compare_memory_path);
+    } else if (issue_width > 0) {
+        if (sampled || record_path || replay_active || restore_path || checkpoint_path || memo_enabled) {
+            fprintf(stderr, "--issue-width does not support sampling, traces, checkpoints or --memo\n");
+            return EXIT_FAILURE;
+        }
+        run_superscalar(issue_width, max_cycles);
+    } else if (ooo_width > 0) {
+        if (sampled || record_path || replay_active || restore_path || checkpoint_path || memo_enabled) {
+            fprintf(stderr, "--ooo does not support sampling, traces, checkpoints or --memo\n");
+            return EXIT_FAILURE;
+        }
+        run_ooo(ooo_width, max_cycles);
+    } else if (record_path) {
+        // Recording runs functionally from PC, so a restored pipeline's in-flight stages would be lost
+        if (restore_path || checkpoint_path) {
+            fprintf(stderr, "--record does not support checkpoints\n");
+            return EXIT_FAILURE;
         }
-        // Decode Stage
-        if (id_stage.active) {
-            instruction_decode(id_stage.instruction, &id_stage.decoded);
-            if (id_stage.cycles_remaining == 1 && !stall) {
-                id_stage.cycles_remaining--;
-                if (!ex_stage.active && !terminate) {
-                    ex_stage.instruction = id_stage.instruction;
-                    ex_stage.instruction_address = id_stage.instruction_address; // propagate address
-                    ex_stage.decoded = id_stage.decoded;
-                    ex_stage.result = 0;
-                    ex_stage.cycles_remaining = 2;
-                    ex_stage.active = true;
-                    id_stage.active = false;
+        if (record_trace(record_path) != 0) {
+            return EXIT_FAILURE;
+        }
+    } else if (sampled) {
+        if (restore_path || checkpoint_path) {
+            fprintf(stderr, "Sampling does not support checkpoints\n");
+            return EXIT_FAILURE;
+        }
+        if (run_sampled(&sample_config) != 0) {
+            return EXIT_FAILURE;
+        }
+    } else {
+        bool terminate = false;
+        bool checkpoint_taken = false;
+        int delta_start = clock_cycle;
+        // Memoization needs real semantics to walk skipped segments, so not in replay
+        if (replay_active) memo_enabled = false;
+        while (!terminate) {
+            if (checkpoint_path && !checkpoint_taken &&
+                ((checkpoint_cycle >= 0 && clock_cycle >= checkpoint_cycle) || (checkpoint_pc >= 0 && PC == (uint32_t)checkpoint_pc))) {
+                checkpoint_taken = true;
+                if (save_checkpoint(checkpoint_path, clock_cycle) != 0) {
+                    return EXIT_FAILURE;
                 }
-            } else if (!stall) {
-                id_stage.cycles_remaining--;
             }
-        }
+            int flushes_before = flush_count;
+            terminate = pipeline_cycle(clock_cycle);
+            // Keep the max cycle count as a safety net against infinite loops
+            if (!terminate && max_cycles > 0 && clock_cycle > max_cycles) {
+                printf("\n[ERROR] Max cycle count reached. Terminating pipeline.\n");
+                terminate = true;
+                terminate_pipeline();
+            }
+            if (!terminate && watch_stop_requested) {
+                printf("\n[BREAK] Stopped at clock cycle %d\n", clock_cycle);
+                terminate = true;
+                terminate_pipeline();
+            }
 
-        // Fetch Stage
-        // Only allow IF if MEM is not active this cycle
-        if (!terminate && flagwork && !stall && !flush_flag && PC < total_instructions && instruction_memory[PC] != 0 && !mem_stage.active) {
-            if (!if_stage.active) {
-                if_stage.instruction = instruction_fetch(instruction_memory);
-                if_stage.instruction_address = PC; // Store the address before incrementing PC
-                if_stage.cycles_remaining = 2;
-                if_stage.active = true;
-                instructions_fetched++;
-                PC++; // PC is incremented here after a successful fetch
+            clock_cycle++;
+            if (!terminate && memo_enabled && flush_count != flushes_before) {
+                memo_segment_boundary(&clock_cycle);
             }
-        }
-        // IF to ID progression (only if not stalling and MEM is not active)
-        if (if_stage.active && if_stage.cycles_remaining == 1 && !stall && !mem_stage.active) {
-            if_stage.cycles_remaining--;
-            if (!id_stage.active) {
-                id_stage.instruction = if_stage.instruction;
-                id_stage.instruction_address = if_stage.instruction_address; // propagate address
-                id_stage.cycles_remaining = 2;
-                id_stage.active = true;
-                if_stage.active = false;
+            if (!terminate && mem_delta_interval > 0 && clock_cycle - delta_start >= mem_delta_interval) {
+                char label[64];
+                snprintf(label, sizeof(label), "cycles %d-%d", delta_start, clock_cycle - 1);
+                memory_delta_report(label);
+                delta_start = clock_cycle;
             }
-        } else if (if_stage.active && !stall && !mem_stage.active) {
-            if_stage.cycles_remaining--;
         }
-        // If stalling, or if MEM is active, IF and ID hold their state (do not decrement cycles_remaining)
-
-        print_pipeline_state(clock_cycle);
-
-        // Exit condition
-        // Stop fetching new instructions once all have been fetched, but let pipeline drain
-        bool pipeline_empty = !if_stage.active && !id_stage.active && !ex_stage.active && !mem_stage.active && !wb_stage.active;
-        bool all_fetched = (instructions_fetched >= total_instructions || PC >= total_instructions);
-        if (pipeline_empty && all_fetched) {
-            terminate = true;
-            terminate_pipeline();
+        printf("\nClock cycles: %d, Instructions committed: %d\n", clock_cycle, instructions_executed);
+        if (memo_enabled) memo_print_stats();
+        if (mem_profile_enabled) mem_profile_print();
+        if (store_buffer_enabled) {
+            store_buffer_print_stats();
+            // Only left over when the cycle limit cut the run short
+            store_buffer_drain_all();
         }
-        // Keep the hard max cycle count as a safety net
-        if (clock_cycle > 1000) { // Hard max cycle count to prevent infinite loop
-            printf("\n[ERROR] Max cycle count reached. Terminating pipeline.\n");
-            terminate = true;
-            terminate_pipeline();
+        if (mem_delta_interval > 0) {
+            char label[64];
+            snprintf(label, sizeof(label), "cycles %d-%d", delta_start, clock_cycle - 1);
+            memory_delta_report(label);
+            mem_delta_interval = -1;
         }
-
-        clock_cycle++;
     }
 
-    print_memory();
-    print_registers();
+    // A replay carries no data, so there is no architectural state to show
+    if (!replay_active) {
+        print_memory();
+        print_registers();
+    }
 
-    return EXIT_SUCCESS;
-}
\ No newline at end of file
+    return finish_memory_reports(mem_delta_interval, "whole run", save_memory_path, compare_memory_path);
+}
+#endif // PIPELINE_NO_MAIN
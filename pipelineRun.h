@@ -2,8 +2,54 @@
 #define PIPELINE_RUN_H
 
 #include <stdint.h>
+#include <stdbool.h>
+#include "funcs.h"
 
-// If you want to expose a function to run the pipeline, declare it here
-// void run_pipeline(const char *filename);
+// Pipeline stage structures
+typedef struct {
+    uint32_t instruction;
+    Instruction decoded;
+    int cycles_remaining;
+    bool active;
+    uint32_t result; // Separate field for execution result
+    uint32_t instruction_address; // <-- Add this field to track instruction index
+    uint32_t trace_index; // Record of this instruction when replaying a trace
+} PipelineStage;
 
-#endif // PIPELINE_RUN_H
\ No newline at end of file
+extern CORE_LOCAL PipelineStage if_stage;
+extern CORE_LOCAL PipelineStage id_stage;
+extern CORE_LOCAL PipelineStage ex_stage;
+extern CORE_LOCAL PipelineStage mem_stage;
+extern CORE_LOCAL PipelineStage wb_stage;
+
+extern CORE_LOCAL bool pending_flush;
+extern CORE_LOCAL uint32_t branch_flush_target;
+extern CORE_LOCAL uint32_t branch_flush_pc;
+extern CORE_LOCAL uint32_t branch_flush_trace_index;
+
+extern CORE_LOCAL int total_instructions;
+extern CORE_LOCAL int instructions_fetched;
+extern CORE_LOCAL int instructions_executed;
+
+// Number of pipeline flushes so far (each taken JEQ/JMP flushes once, at its WB)
+extern CORE_LOCAL int flush_count;
+
+// When false IF stops fetching so the in-flight instructions can drain
+extern CORE_LOCAL bool fetch_enabled;
+
+// True if the instruction about to leave ID must wait for an older one in EX/MEM/WB
+bool has_data_hazard(Instruction *curr, PipelineStage *id, PipelineStage *ex, PipelineStage *mem, PipelineStage *wb);
+
+// Parse an assembly file into this core's instruction memory; returns 0 on success
+int load_program(const char *filename);
+
+// Empty every stage (used before starting a fresh detailed window)
+void reset_pipeline(void);
+
+// True when no stage holds an instruction
+bool pipeline_is_empty(void);
+
+// Simulate one clock cycle of the 5-stage model; returns true once the program has finished
+bool pipeline_cycle(int clock_cycle);
+
+#endif // PIPELINE_RUN_H
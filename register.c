@@ -5,8 +5,8 @@
 #define NUM_REGISTERS 32
 
 // Register file
-uint32_t registers[NUM_REGISTERS] = {0}; // R0 to R31
-uint32_t PC = 0;                          // Program Counter
+CORE_LOCAL uint32_t registers[NUM_REGISTERS] = {0}; // R0 to R31
+CORE_LOCAL uint32_t PC = 0;                          // Program Counter
 
 // Initialize all registers to 0 (R0 is always zero)
 void init_registers()
@@ -2,11 +2,12 @@
 #define REGISTERS_H
 
 #include <stdint.h>
+#include "corelocal.h"
 
 #define NUM_REGISTERS 32
 
-extern uint32_t registers[NUM_REGISTERS];
-extern uint32_t PC;
+extern CORE_LOCAL uint32_t registers[NUM_REGISTERS];
+extern CORE_LOCAL uint32_t PC;
 
 void init_registers();
 uint32_t get_register(uint8_t index);
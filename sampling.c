@@ -0,0 +1,136 @@
+// sampling.c
+// Sampled simulation: functional fast-forward with periodic detailed windows
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+#include "registers.h"
+#include "memory.h"
+#include "funcs.h"
+#include "pipelineRun.h"
+#include "functional.h"
+#include "sampling.h"
+
+// Two-sided 95% Student t critical values for 1..30 degrees of freedom
+static const double t_table_95[30] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+};
+
+static double t_critical_95(int dof) {
+    if (dof < 1) return 0.0;
+    if (dof <= 30) return t_table_95[dof - 1];
+    return 1.960;
+}
+
+// Simulate one detailed window starting from an empty pipeline at the current PC.
+// Returns the measured CPI, or a negative value if the program ended before
+// any instruction of the measurement window committed.
+static double run_detailed_window(const SampleConfig *config, int *clock_cycle,
+                                  uint64_t *committed, uint64_t *detailed_cycles) {
+    int start_executed = instructions_executed;
+    int measure_start_cycle = -1;
+    uint64_t measure_start_count = 0;
+    int window_cycles = 0;
+    uint64_t retired = 0;
+
+    reset_pipeline();
+    fetch_enabled = true;
+
+    if (config->warmup == 0) {
+        measure_start_cycle = 0;
+    }
+
+    while (retired < config->warmup + config->measure) {
+        bool done = pipeline_cycle((*clock_cycle)++);
+        window_cycles++;
+        retired = (uint64_t)(instructions_executed - start_executed);
+
+        if (measure_start_cycle < 0 && retired >= config->warmup) {
+            measure_start_cycle = window_cycles;
+            measure_start_count = retired;
+        }
+        if (done || (pipeline_is_empty() && program_halted())) break;
+    }
+    int measure_end_cycle = window_cycles;
+    uint64_t measure_end_count = retired;
+
+    // Stop fetching and let the in-flight instructions commit so PC is precise again
+    fetch_enabled = false;
+    while (!pipeline_is_empty()) {
+        pipeline_cycle((*clock_cycle)++);
+        window_cycles++;
+    }
+    fetch_enabled = true;
+
+    *committed += (uint64_t)(instructions_executed - start_executed);
+    *detailed_cycles += (uint64_t)window_cycles;
+
+    if (measure_start_cycle < 0 || measure_end_count <= measure_start_count) {
+        return -1.0;
+    }
+    return (double)(measure_end_cycle - measure_start_cycle) /
+           (double)(measure_end_count - measure_start_count);
+}
+
+int run_sampled(const SampleConfig *config) {
+    if (config->measure == 0 || config->interval < config->warmup + config->measure) {
+        fprintf(stderr, "Sampling Error: need MEASURE > 0 and INTERVAL >= WARMUP + MEASURE.\n");
+        return -1;
+    }
+
+    // Running mean and sum of squared deviations (Welford), so any number of windows fits
+    int sample_count = 0;
+    double mean = 0.0;
+    double m2 = 0.0;
+    int clock_cycle = 0;
+    uint64_t committed = 0;
+    uint64_t fast_forwarded = 0;
+    uint64_t detailed_cycles = 0;
+    uint64_t skip = config->interval - config->warmup - config->measure;
+
+    while (!program_halted()) {
+        // Fast-forward architectural state up to the next sample point
+        for (uint64_t i = 0; i < skip && functional_step(); i++) {
+            fast_forwarded++;
+        }
+        if (program_halted()) break;
+
+        double cpi = run_detailed_window(config, &clock_cycle, &committed, &detailed_cycles);
+        if (cpi >= 0.0) {
+            sample_count++;
+            double delta = cpi - mean;
+            mean += delta / sample_count;
+            m2 += delta * (cpi - mean);
+        }
+    }
+    committed += fast_forwarded;
+
+    printf("\n======= Sampled Simulation =======\n");
+    printf("Committed instructions : %llu (%llu fast-forwarded, %llu detailed)\n",
+           (unsigned long long)committed, (unsigned long long)fast_forwarded,
+           (unsigned long long)(committed - fast_forwarded));
+    printf("Detailed cycles        : %llu\n", (unsigned long long)detailed_cycles);
+    printf("Samples                : %d (warm-up %llu, measure %llu, interval %llu)\n",
+           sample_count, (unsigned long long)config->warmup,
+           (unsigned long long)config->measure, (unsigned long long)config->interval);
+
+    if (sample_count == 0) {
+        printf("No complete measurement window; program too short for this configuration.\n");
+        return 0;
+    }
+
+    double variance = sample_count > 1 ? m2 / (sample_count - 1) : 0.0;
+
+    double half_width = t_critical_95(sample_count - 1) * sqrt(variance / sample_count);
+    double estimated_cycles = mean * (double)committed;
+
+    printf("Mean CPI               : %.4f +/- %.4f (95%% CI)\n", mean, half_width);
+    printf("Estimated total cycles : %.0f [%.0f, %.0f]\n", estimated_cycles,
+           (mean - half_width) * (double)committed, (mean + half_width) * (double)committed);
+    if (sample_count == 1) {
+        printf("Only one sample: confidence interval is not available.\n");
+    }
+    return 0;
+}
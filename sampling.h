@@ -0,0 +1,18 @@
+#ifndef SAMPLING_H
+#define SAMPLING_H
+
+#include <stdint.h>
+
+// Sampled simulation: fast-forward functionally, then run the detailed
+// pipeline for a warm-up + measurement window once every `interval` instructions
+typedef struct {
+    uint64_t interval; // Instructions from the start of one sample to the next
+    uint64_t warmup;   // Committed instructions simulated in detail but not measured
+    uint64_t measure;  // Committed instructions whose cycles are measured
+} SampleConfig;
+
+// Run the loaded program to completion in sampled mode and print the CPI estimate.
+// Returns 0 on success, -1 on an invalid configuration.
+int run_sampled(const SampleConfig *config);
+
+#endif // SAMPLING_H
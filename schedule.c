@@ -0,0 +1,236 @@
+// schedule.c
+// Hazard-aware static instruction scheduling per basic block
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "registers.h"
+#include "memory.h"
+#include "funcs.h"
+#include "pipelineRun.h"
+#include "trace.h"
+#include "hooks.h"
+#include "schedule.h"
+
+#define MAX_BLOCK 64 // Longer blocks are scheduled in chunks of this size
+
+bool schedule_enabled = false;
+
+// Per-instruction facts the dependency graph is built from
+typedef struct {
+    uint32_t word;
+    Instruction decoded;
+    uint8_t dest;            // Register written, 0 if none
+    uint8_t sources[2];      // Registers read, 0 if unused
+    bool is_load;
+    bool is_store;
+    bool is_branch;
+    uint32_t base_version;   // Number of writes to the base register before a MOVR/MOVM
+    uint32_t mem_key;        // Stand-in address for the timing oracle
+} SchedNode;
+
+static SchedNode nodes[MAX_INSTRUCTIONS];
+
+static void describe(SchedNode *node, uint32_t word) {
+    memset(node, 0, sizeof(*node));
+    node->word = word;
+    instruction_decode(word, &node->decoded);
+    Instruction *in = &node->decoded;
+    int op = in->opcode;
+    // Same source/destination table as has_data_hazard()
+    if (op <= 5) {
+        node->sources[0] = in->r2;
+        node->sources[1] = in->r3;
+    } else if (op == 7) {
+        node->sources[0] = in->r1;
+        node->sources[1] = in->r2;
+    } else if (op == 8) {
+        node->sources[0] = in->r1;
+    } else if (op == 9) {
+        node->sources[0] = in->r2;
+    } else if (op == 10) {
+        node->sources[0] = in->r1;
+        node->sources[1] = in->r2;
+    }
+    if (op <= 6 || op == 8 || op == 9) node->dest = in->r1;
+    node->is_load = op == 9;
+    node->is_store = op == 10;
+    node->is_branch = op == 7 || op == 11;
+}
+
+static bool reads(const SchedNode *node, uint8_t reg) {
+    return reg != 0 && (node->sources[0] == reg || node->sources[1] == reg);
+}
+
+// True if `later` must stay after `earlier` (indices in original order)
+static bool depends(const SchedNode *earlier, const SchedNode *later) {
+    if (later->is_branch || earlier->is_branch) return true;
+    if (earlier->dest && (reads(later, earlier->dest) || later->dest == earlier->dest)) return true; // RAW, WAW
+    if (later->dest && reads(earlier, later->dest)) return true; // WAR
+    if ((earlier->is_store && (later->is_load || later->is_store)) || (earlier->is_load && later->is_store)) {
+        // Same base register value with a different offset cannot alias; anything else might
+        bool same_base = earlier->decoded.r2 == later->decoded.r2 && earlier->base_version == later->base_version;
+        return !(same_base && earlier->decoded.imm != later->decoded.imm);
+    }
+    return false;
+}
+
+// Cycles the pipeline needs for `order` run straight through from an empty pipeline
+static int block_cycles(const int *order, int n) {
+    static TraceRecord records[MAX_BLOCK];
+    for (int i = 0; i < n; i++) {
+        const SchedNode *node = &nodes[order[i]];
+        records[i].pc = (uint32_t)i;
+        records[i].instruction = node->word;
+        records[i].mem_address = node->mem_key;
+        records[i].branch_dest = 0;
+        records[i].taken = 0; // A block's final branch does not change its own timing
+    }
+
+    // Borrow the replay engine and the pipeline, then put everything back
+    bool saved_replay = replay_active;
+    TraceRecord *saved_records = trace_records;
+    uint32_t saved_length = trace_length;
+    uint32_t saved_cursor = replay_cursor;
+    bool saved_trace = trace_enabled;
+    uint32_t saved_pc = PC;
+    int saved_fetched = instructions_fetched;
+    int saved_executed = instructions_executed;
+    int saved_flushes = flush_count;
+#ifndef PIPELINE_NO_HOOKS
+    // Trial runs are not part of the program, so no hook sees them
+    unsigned saved_hooks = hooks_active;
+    hooks_active = 0;
+#endif
+
+    replay_active = true;
+    trace_records = records;
+    trace_length = (uint32_t)n;
+    replay_cursor = 0;
+    trace_enabled = false;
+    reset_pipeline();
+
+    int cycle = 0;
+    while (!pipeline_cycle(cycle)) cycle++;
+
+    replay_active = saved_replay;
+    trace_records = saved_records;
+    trace_length = saved_length;
+    replay_cursor = saved_cursor;
+    trace_enabled = saved_trace;
+    PC = saved_pc;
+    instructions_fetched = saved_fetched;
+    instructions_executed = saved_executed;
+    flush_count = saved_flushes;
+#ifndef PIPELINE_NO_HOOKS
+    hooks_active = saved_hooks;
+#endif
+    reset_pipeline();
+    return cycle + 1;
+}
+
+// List-schedule nodes[start, start + n); writes the chosen order and returns its cycles
+static int schedule_block(int start, int n, int *order) {
+    int scheduled[MAX_BLOCK];
+    bool placed[MAX_BLOCK] = {false};
+
+    for (int k = 0; k < n; k++) {
+        int best = -1;
+        int best_cycles = 0;
+        for (int c = 0; c < n; c++) {
+            if (placed[c]) continue;
+            bool ready = true;
+            for (int p = 0; p < c && ready; p++) {
+                if (!placed[p] && depends(&nodes[start + p], &nodes[start + c])) ready = false;
+            }
+            if (!ready) continue;
+            scheduled[k] = start + c;
+            int cycles = block_cycles(scheduled, k + 1);
+            if (best < 0 || cycles < best_cycles) {
+                best = c;
+                best_cycles = cycles;
+            }
+        }
+        placed[best] = true;
+        scheduled[k] = start + best;
+    }
+    memcpy(order, scheduled, n * sizeof(int));
+    return block_cycles(order, n);
+}
+
+void schedule_program(uint32_t *program, int count) {
+    bool leader[MAX_INSTRUCTIONS + 1] = {false};
+    uint32_t versions[NUM_REGISTERS] = {0};
+    uint32_t key_base[MAX_INSTRUCTIONS];
+    int key_count = 0;
+
+    // Decode, find block leaders and give each MOVR/MOVM a symbolic address
+    for (int i = 0; i < count; i++) {
+        SchedNode *node = &nodes[i];
+        describe(node, program[i]);
+        if (node->is_load || node->is_store) {
+            node->base_version = versions[node->decoded.r2];
+            uint32_t key = node->decoded.r2 * 0x9E3779B1u ^ node->base_version * 0x85EBCA6Bu ^ (uint32_t)node->decoded.imm;
+            int k = 0;
+            while (k < key_count && key_base[k] != key) k++;
+            if (k == key_count) key_base[key_count++] = key;
+            node->mem_key = (uint32_t)k;
+        }
+        if (node->dest) versions[node->dest]++;
+
+        if (node->decoded.opcode == 7) {
+            int32_t target = i + node->decoded.imm;
+            if (target >= 0 && target < count) leader[target] = true;
+            leader[i + 1] = true;
+        } else if (node->decoded.opcode == 11) {
+            if (node->decoded.addr < (uint32_t)count) leader[node->decoded.addr] = true;
+            leader[i + 1] = true;
+        } else if (program[i] == 0) {
+            // A zero word ends the program, so it must not move
+            leader[i] = true;
+            leader[i + 1] = true;
+        }
+    }
+    leader[0] = true;
+
+    int blocks = 0;
+    int reordered = 0;
+    long original_total = 0;
+    long scheduled_total = 0;
+    uint32_t output[MAX_INSTRUCTIONS];
+    int order[MAX_BLOCK];
+    int identity[MAX_BLOCK];
+
+    for (int start = 0; start < count; ) {
+        int n = 1;
+        while (start + n < count && !leader[start + n] && n < MAX_BLOCK) n++;
+
+        for (int i = 0; i < n; i++) identity[i] = start + i;
+        int original = block_cycles(identity, n);
+        int scheduled = n > 1 ? schedule_block(start, n, order) : original;
+        if (n == 1 || scheduled >= original) {
+            memcpy(order, identity, n * sizeof(int));
+            scheduled = original;
+        }
+
+        bool moved = false;
+        for (int i = 0; i < n; i++) {
+            output[start + i] = program[order[i]];
+            if (order[i] != start + i) moved = true;
+        }
+        if (moved) {
+            reordered++;
+            TRACE("[SCHED] Block %d-%d: %d -> %d cycles\n", start, start + n - 1, original, scheduled);
+        }
+        blocks++;
+        original_total += original;
+        scheduled_total += scheduled;
+        start += n;
+    }
+    memcpy(program, output, count * sizeof(uint32_t));
+
+    printf("\n======= Static Scheduling =======\n");
+    printf("Basic blocks         : %d (%d reordered)\n", blocks, reordered);
+    printf("Predicted cycles     : %ld original, %ld scheduled (each block once, from an empty pipeline)\n",
+           original_total, scheduled_total);
+}
@@ -0,0 +1,21 @@
+#ifndef SCHEDULE_H
+#define SCHEDULE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Static instruction scheduling applied to the encoded program before it runs.
+// Each basic block gets a dependency graph (register RAW/WAR/WAW plus MOVR/MOVM
+// memory order), then is list-scheduled greedily: at every step the ready
+// instruction that keeps the block's cycle count lowest is placed next. Block
+// cycles are measured on the real pipeline in trace-replay mode, so the pass
+// follows the simulator's actual stall rules. Branches stay last in their block
+// and block start addresses never move, so JEQ/JMP targets remain valid.
+
+extern bool schedule_enabled;
+
+// Reorder `program` in place and print predicted cycles before and after.
+// Must be called before the simulation starts (it borrows the pipeline).
+void schedule_program(uint32_t *program, int count);
+
+#endif // SCHEDULE_H
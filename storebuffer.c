@@ -0,0 +1,72 @@
+// storebuffer.c
+// MOVM store buffer with store-to-load forwarding
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "memory.h"
+#include "funcs.h"
+#include "storebuffer.h"
+
+typedef struct {
+    uint32_t address;
+    uint32_t value;
+} BufferedStore;
+
+bool store_buffer_enabled = false;
+int store_buffer_capacity = DEFAULT_STORE_BUFFER_ENTRIES;
+int store_buffer_count = 0;
+long store_buffer_forwards = 0;
+long store_buffer_full_stalls = 0;
+
+static BufferedStore entries[MAX_STORE_BUFFER_ENTRIES];
+static int head = 0; // Oldest entry
+static long pushes = 0;
+static long lookups = 0;
+static int max_occupancy = 0;
+
+bool store_buffer_full(void) {
+    return store_buffer_count >= store_buffer_capacity;
+}
+
+void store_buffer_push(uint32_t address, uint32_t value) {
+    int slot = (head + store_buffer_count) % MAX_STORE_BUFFER_ENTRIES;
+    entries[slot].address = address;
+    entries[slot].value = value;
+    store_buffer_count++;
+    pushes++;
+    if (store_buffer_count > max_occupancy) max_occupancy = store_buffer_count;
+    TRACE("[STORE BUFFER] Queued memory[%u] = %d (%d/%d)\n", address, (int32_t)value, store_buffer_count, store_buffer_capacity);
+}
+
+bool store_buffer_lookup(uint32_t address, uint32_t *value) {
+    lookups++;
+    for (int i = store_buffer_count - 1; i >= 0; i--) {
+        BufferedStore *entry = &entries[(head + i) % MAX_STORE_BUFFER_ENTRIES];
+        if (entry->address == address) {
+            *value = entry->value;
+            store_buffer_forwards++;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool store_buffer_drain(void) {
+    if (store_buffer_count == 0) return false;
+    BufferedStore *entry = &entries[head];
+    memory_write(entry->address, entry->value);
+    TRACE("[STORE BUFFER] Retired memory[%u] = %d\n", entry->address, (int32_t)entry->value);
+    head = (head + 1) % MAX_STORE_BUFFER_ENTRIES;
+    store_buffer_count--;
+    return true;
+}
+
+void store_buffer_drain_all(void) {
+    while (store_buffer_drain()) {
+    }
+}
+
+void store_buffer_print_stats(void) {
+    printf("Store buffer (%d entries): %ld stores, max occupancy %d, MOVR forwarding hits %ld of %ld, buffer-full stalls %ld\n",
+           store_buffer_capacity, pushes, max_occupancy, store_buffer_forwards, lookups, store_buffer_full_stalls);
+}
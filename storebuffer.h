@@ -0,0 +1,39 @@
+#ifndef STORE_BUFFER_H
+#define STORE_BUFFER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Store buffer between MEM and data memory. A MOVM leaves MEM by queueing its
+// address and value here instead of writing memory, so it neither needs the
+// memory port nor blocks IF. Entries retire to memory oldest first, one per
+// cycle, in cycles where neither a fetch nor a MOVR uses the port. A MOVR
+// takes its value from the youngest buffered store to the same address.
+// A MOVM that finds the buffer full waits in MEM while the oldest entry is
+// forced out.
+//
+// Only instructions that have passed MEM enter the buffer and no flush reaches
+// that far back, so buffered stores are never squashed.
+
+#define DEFAULT_STORE_BUFFER_ENTRIES 4
+#define MAX_STORE_BUFFER_ENTRIES 64
+
+extern bool store_buffer_enabled;
+extern int store_buffer_capacity;
+extern int store_buffer_count;
+extern long store_buffer_forwards;     // MOVRs satisfied from the buffer
+extern long store_buffer_full_stalls;  // Cycles a MOVM waited in MEM for a free entry
+
+bool store_buffer_full(void);
+void store_buffer_push(uint32_t address, uint32_t value);
+
+// Youngest buffered value for `address`; returns false if none is buffered
+bool store_buffer_lookup(uint32_t address, uint32_t *value);
+
+// Write the oldest entry to memory; returns false if the buffer was empty
+bool store_buffer_drain(void);
+void store_buffer_drain_all(void);
+
+void store_buffer_print_stats(void);
+
+#endif // STORE_BUFFER_H
@@ -0,0 +1,275 @@
+// superscalar.c
+// Configurable-width in-order pipeline
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "registers.h"
+#include "memory.h"
+#include "funcs.h"
+#include "pipelineRun.h"
+#include "superscalar.h"
+#include "hooks.h"
+#include "watch.h"
+
+#define UNIT_ALU    0x1
+#define UNIT_MUL    0x2
+#define UNIT_MEM    0x4
+#define UNIT_BRANCH 0x8
+
+// One pipeline stage: up to `width` instructions, oldest first, moving together
+typedef struct {
+    PipelineStage slot[MAX_ISSUE_WIDTH];
+    int count;
+    int cycles_remaining;
+} StageGroup;
+
+static StageGroup if_group, id_group, ex_group, mem_group, wb_group;
+static int issue_width = 2;
+
+// Why ID could not issue its whole group
+static long issue_histogram[MAX_ISSUE_WIDTH + 1];
+static long stalls_hazard = 0;     // Waiting for an older group (RAW / MOVM->MOVR)
+static long stalls_pair = 0;       // Dependent on an older instruction of the same group
+static long stalls_unit = 0;       // Needed a functional unit its slot does not have
+
+static int required_unit(const Instruction *instr) {
+    switch (instr->opcode) {
+        case 2: return UNIT_MUL;
+        case 7: case 11: return UNIT_BRANCH;
+        case 9: case 10: return UNIT_MEM;
+        default: return UNIT_ALU;
+    }
+}
+
+static int slot_units(int slot) {
+    return slot == 0 ? (UNIT_ALU | UNIT_MUL | UNIT_MEM | UNIT_BRANCH) : (UNIT_ALU | UNIT_BRANCH);
+}
+
+static void clear_group(StageGroup *group, int cycles) {
+    for (int i = 0; i < group->count; i++) group->slot[i].active = false;
+    group->count = 0;
+    group->cycles_remaining = cycles;
+}
+
+static bool groups_empty(void) {
+    return !if_group.count && !id_group.count && !ex_group.count && !mem_group.count && !wb_group.count;
+}
+
+// RAW / MOVM->MOVR hazard of `curr` against every instruction still in EX, MEM or WB
+static bool hazard_with_older_groups(PipelineStage *curr) {
+    static PipelineStage empty;
+    for (int s = 0; s < issue_width; s++) {
+        PipelineStage *ex = s < ex_group.count ? &ex_group.slot[s] : &empty;
+        PipelineStage *mem = s < mem_group.count ? &mem_group.slot[s] : &empty;
+        PipelineStage *wb = s < wb_group.count ? &wb_group.slot[s] : &empty;
+        if (has_data_hazard(&curr->decoded, curr, ex, mem, wb)) return true;
+    }
+    return false;
+}
+
+// Same check against an older instruction of the group being issued, treated as if it were in EX
+static bool hazard_with_pair(PipelineStage *curr, PipelineStage *older) {
+    static PipelineStage empty;
+    return has_data_hazard(&curr->decoded, curr, older, &empty, &empty);
+}
+
+static void move_group(StageGroup *to, StageGroup *from, int count, int cycles) {
+    for (int i = 0; i < count; i++) {
+        to->slot[i] = from->slot[i];
+        to->slot[i].active = true;
+    }
+    to->count = count;
+    to->cycles_remaining = cycles;
+    // Anything not moved slides down to the front of `from`
+    for (int i = count; i < from->count; i++) from->slot[i - count] = from->slot[i];
+    for (int i = from->count - count; i < from->count; i++) from->slot[i].active = false;
+    from->count -= count;
+}
+
+static void print_group(const char *name, const StageGroup *group) {
+    TRACE("%s:", name);
+    if (!group->count) TRACE(" Inactive");
+    for (int i = 0; i < group->count; i++) TRACE(" [%u] 0x%08X", group->slot[i].instruction_address, group->slot[i].instruction);
+    TRACE(" (Cycles: %d)\n", group->cycles_remaining);
+}
+
+// One clock cycle; returns true once the program has finished
+static bool superscalar_cycle(int clock_cycle) {
+    bool stall = false;
+    TRACE("\nClock Cycle %d:\n", clock_cycle);
+
+    // Write Back: the whole group commits in program order
+    if (wb_group.count && wb_group.cycles_remaining == 1) {
+        for (int i = 0; i < wb_group.count; i++) {
+            finalResult = wb_group.slot[i].result;
+            HOOK_SET_PC(wb_group.slot[i].instruction_address);
+            write_back(&wb_group.slot[i].decoded, wb_group.slot[i].result);
+            instructions_executed++;
+            HOOK(HOOK_RETIRE, .pc = wb_group.slot[i].instruction_address, .instruction = wb_group.slot[i].instruction);
+        }
+        // A taken branch is always the last instruction of its group
+        if (pending_flush) {
+            HOOK(HOOK_FLUSH, .pc = wb_group.slot[wb_group.count - 1].instruction_address,
+                 .instruction = wb_group.slot[wb_group.count - 1].instruction, .value = branch_flush_target);
+        }
+        clear_group(&wb_group, 1);
+        if (pending_flush) {
+            clear_group(&if_group, 2);
+            clear_group(&id_group, 2);
+            clear_group(&ex_group, 2);
+            clear_group(&mem_group, 1);
+            TRACE("[FLUSH] Pipeline flushed after WB. Old PC: %u, New PC: %u\n", PC, branch_flush_target);
+            PC = branch_flush_target;
+            pending_flush = false;
+            flush_flag = 0;
+            flush_count++;
+            return false;
+        }
+    }
+
+    // Memory: at most one MOVR/MOVM per group, so one port access
+    if (mem_group.count && mem_group.cycles_remaining == 1) {
+        for (int i = 0; i < mem_group.count; i++) {
+            HOOK_SET_PC(mem_group.slot[i].instruction_address);
+            memory_access(memory, &mem_group.slot[i].decoded);
+            if (mem_group.slot[i].decoded.opcode == 9) mem_group.slot[i].result = finalResult;
+        }
+        mem_group.cycles_remaining--;
+        if (!wb_group.count) move_group(&wb_group, &mem_group, mem_group.count, 1);
+    }
+
+    // Execute: in order; a taken branch squashes the younger slots of its own group
+    if (ex_group.count) {
+        if (ex_group.cycles_remaining == 1) {
+            for (int i = 0; i < ex_group.count; i++) {
+                PipelineStage *slot = &ex_group.slot[i];
+                slot->result = execute(&slot->decoded, slot->instruction_address);
+                if (flush_flag) {
+                    pending_flush = true;
+                    branch_flush_target = branch_target;
+                    for (int j = i + 1; j < ex_group.count; j++) ex_group.slot[j].active = false;
+                    ex_group.count = i + 1;
+                    break;
+                }
+            }
+            ex_group.cycles_remaining--;
+            if (!mem_group.count) move_group(&mem_group, &ex_group, ex_group.count, 1);
+        } else {
+            ex_group.cycles_remaining--;
+        }
+    }
+
+    // Decode / issue
+    if (id_group.count) {
+        for (int i = 0; i < id_group.count; i++) {
+            instruction_decode(id_group.slot[i].instruction, &id_group.slot[i].decoded);
+        }
+        if (id_group.cycles_remaining == 1) {
+            int issue = 0;
+            int branches = 0;
+            while (issue < id_group.count) {
+                PipelineStage *curr = &id_group.slot[issue];
+                int unit = required_unit(&curr->decoded);
+                bool pair_hazard = false;
+                for (int older = 0; older < issue && !pair_hazard; older++) {
+                    pair_hazard = hazard_with_pair(curr, &id_group.slot[older]);
+                }
+                if (hazard_with_older_groups(curr)) {
+                    stalls_hazard++;
+                    break;
+                }
+                if (pair_hazard) {
+                    stalls_pair++;
+                    break;
+                }
+                if (!(slot_units(issue) & unit) || (unit == UNIT_BRANCH && branches > 0)) {
+                    stalls_unit++;
+                    break;
+                }
+                if (unit == UNIT_BRANCH) branches++;
+                issue++;
+            }
+            if (issue == 0) {
+                stall = true;
+                TRACE("[STALL] Data hazard detected. Stalling pipeline.\n");
+                HOOK(HOOK_STALL, .pc = id_group.slot[0].instruction_address, .instruction = id_group.slot[0].instruction);
+            } else if (!ex_group.count) {
+                issue_histogram[issue]++;
+                for (int i = 0; i < issue; i++) {
+                    HOOK(HOOK_DECODE, .pc = id_group.slot[i].instruction_address, .instruction = id_group.slot[i].instruction);
+                }
+                move_group(&ex_group, &id_group, issue, 2);
+                // A split group keeps its remaining instructions in ID, still decoded
+                if (id_group.count) id_group.cycles_remaining = 1;
+            }
+        } else {
+            id_group.cycles_remaining--;
+        }
+    }
+
+    // Fetch: a group of sequential instructions, only while MEM leaves the port free
+    if (!stall && !flush_flag && !mem_group.count && !if_group.count && fetch_enabled &&
+        PC < (uint32_t)total_instructions && instruction_memory[PC] != 0) {
+        int n = 0;
+        while (n < issue_width && PC < (uint32_t)total_instructions && instruction_memory[PC] != 0) {
+            PipelineStage *slot = &if_group.slot[n++];
+            memset(slot, 0, sizeof(*slot));
+            slot->instruction = instruction_fetch(instruction_memory);
+            slot->instruction_address = PC;
+            slot->active = true;
+            instructions_fetched++;
+            PC++;
+        }
+        if_group.count = n;
+        if_group.cycles_remaining = 2;
+    }
+    // IF to ID progression (held while stalling or while MEM is active)
+    if (if_group.count && !stall && !mem_group.count) {
+        if (if_group.cycles_remaining == 1) {
+            if (!id_group.count) move_group(&id_group, &if_group, if_group.count, 2);
+        } else {
+            if_group.cycles_remaining--;
+        }
+    }
+
+    print_group("IF", &if_group);
+    print_group("ID", &id_group);
+    print_group("EX", &ex_group);
+    print_group("MEM", &mem_group);
+    print_group("WB", &wb_group);
+    TRACE("PC: %d, Flush Flag: %d\n", PC, flush_flag);
+
+    return groups_empty() && (PC >= (uint32_t)total_instructions || instruction_memory[PC] == 0);
+}
+
+int run_superscalar(int width, long max_cycles) {
+    if (width < 1) width = 1;
+    if (width > MAX_ISSUE_WIDTH) width = MAX_ISSUE_WIDTH;
+    issue_width = width;
+    clear_group(&if_group, 2);
+    clear_group(&id_group, 2);
+    clear_group(&ex_group, 2);
+    clear_group(&mem_group, 1);
+    clear_group(&wb_group, 1);
+
+    int clock_cycle = 0;
+    bool terminate = false;
+    while (!terminate) {
+        terminate = superscalar_cycle(clock_cycle) || watch_stop_requested;
+        if (!terminate && max_cycles > 0 && clock_cycle > max_cycles) {
+            printf("\n[ERROR] Max cycle count reached. Terminating pipeline.\n");
+            terminate = true;
+        }
+        clock_cycle++;
+    }
+
+    printf("\n======= Superscalar (issue width %d) =======\n", width);
+    printf("Clock cycles: %d, Instructions committed: %d, IPC: %.3f\n", clock_cycle, instructions_executed,
+           clock_cycle ? (double)instructions_executed / clock_cycle : 0.0);
+    printf("Issue groups:");
+    for (int i = 1; i <= width; i++) printf(" %d-wide %ld", i, issue_histogram[i]);
+    printf("\nIssue limited by: older-group hazard %ld, same-group dependence %ld, slot unit %ld\n",
+           stalls_hazard, stalls_pair, stalls_unit);
+    return clock_cycle;
+}
@@ -0,0 +1,23 @@
+#ifndef SUPERSCALAR_H
+#define SUPERSCALAR_H
+
+#include <stdint.h>
+
+// In-order superscalar mode: every stage holds a group of up to `width`
+// instructions. IF fetches a group of sequential instructions in one 2-cycle
+// fetch; ID issues the oldest instructions of its group together when they
+// are independent of each other and of the older groups in flight and fit the
+// issue slots' functional units. The single memory port is shared as in the
+// scalar model: IF cannot fetch while MEM holds a group.
+//
+// Slot 0 has every unit (ALU, multiplier, memory, branch); the other slots
+// have an ALU and the branch unit. A group issues at most one branch.
+// With width 1 the timing matches the scalar pipeline exactly.
+
+#define MAX_ISSUE_WIDTH 8
+
+// Run the loaded program to completion; max_cycles of 0 means no limit.
+// Returns the number of simulated cycles.
+int run_superscalar(int width, long max_cycles);
+
+#endif // SUPERSCALAR_H
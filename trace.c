@@ -0,0 +1,126 @@
+// trace.c
+// Record-once, replay-many: committed instruction stream for timing-only runs
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "registers.h"
+#include "memory.h"
+#include "funcs.h"
+#include "pipelineRun.h"
+#include "functional.h"
+#include "trace.h"
+
+#define TRACE_MAGIC 0x5254504Eu // "NPTR"
+#define TRACE_VERSION 1
+#define MAX_TRACE_RECORDS 10000000u
+
+bool replay_active = false;
+TraceRecord *trace_records = NULL;
+uint32_t trace_length = 0;
+uint32_t replay_cursor = 0;
+
+// On-disk layout of a record: fixed-width fields, no struct padding
+static bool write_record(FILE *file, const TraceRecord *record) {
+    uint32_t words[4] = {record->pc, record->instruction, record->mem_address, record->branch_dest};
+    return fwrite(words, sizeof(words), 1, file) == 1 && fputc(record->taken, file) != EOF;
+}
+
+static bool read_record(FILE *file, TraceRecord *record) {
+    uint32_t words[4];
+    int taken;
+    if (fread(words, sizeof(words), 1, file) != 1 || (taken = fgetc(file)) == EOF) return false;
+    record->pc = words[0];
+    record->instruction = words[1];
+    record->mem_address = words[2];
+    record->branch_dest = words[3];
+    record->taken = (uint8_t)taken;
+    return true;
+}
+
+int record_trace(const char *path) {
+    FILE *file = fopen(path, "wb");
+    if (!file) {
+        perror("Error opening trace file");
+        return -1;
+    }
+
+    // Count is patched into the header once the run has finished
+    uint32_t header[3] = {TRACE_MAGIC, TRACE_VERSION, 0};
+    bool ok = fwrite(header, sizeof(header), 1, file) == 1;
+
+    uint32_t count = 0;
+    while (ok && !program_halted()) {
+        if (count == MAX_TRACE_RECORDS) {
+            fprintf(stderr, "Trace Warning: stopped recording after %u instructions.\n", count);
+            break;
+        }
+        TraceRecord record = {0};
+        Instruction instr;
+        record.pc = PC;
+        record.instruction = instruction_memory[PC];
+        instruction_decode(record.instruction, &instr);
+        if (instr.opcode == 9 || instr.opcode == 10) {
+            record.mem_address = registers[instr.r2] + instr.imm;
+        }
+        // A taken branch flushes even when its target is the next instruction
+        record.taken = instr.opcode == 11 || (instr.opcode == 7 && registers[instr.r1] == registers[instr.r2]);
+
+        functional_step();
+        if (record.taken) {
+            record.branch_dest = PC;
+        }
+        ok = write_record(file, &record);
+        count++;
+    }
+
+    header[2] = count;
+    ok = ok && fseek(file, 0, SEEK_SET) == 0 && fwrite(header, sizeof(header), 1, file) == 1;
+    if (fclose(file) != 0) ok = false;
+    if (!ok) {
+        fprintf(stderr, "Trace Error: failed to write %s\n", path);
+        return -1;
+    }
+    printf("[TRACE] Recorded %u committed instructions to %s\n", count, path);
+    return 0;
+}
+
+int load_trace(const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        perror("Error opening trace file");
+        return -1;
+    }
+
+    uint32_t header[3];
+    bool ok = fread(header, sizeof(header), 1, file) == 1 &&
+              header[0] == TRACE_MAGIC && header[1] == TRACE_VERSION && header[2] <= MAX_TRACE_RECORDS;
+    if (ok) {
+        free(trace_records);
+        trace_records = malloc((header[2] ? header[2] : 1) * sizeof(TraceRecord));
+        ok = trace_records != NULL;
+    }
+    for (uint32_t i = 0; ok && i < header[2]; i++) {
+        ok = read_record(file, &trace_records[i]);
+    }
+    fclose(file);
+
+    if (!ok) {
+        fprintf(stderr, "Trace Error: %s is not a valid trace\n", path);
+        return -1;
+    }
+    trace_length = header[2];
+    replay_cursor = 0;
+    replay_active = true;
+    return 0;
+}
+
+uint32_t replay_execute(const PipelineStage *stage) {
+    const TraceRecord *record = &trace_records[stage->trace_index];
+    if (record->taken) {
+        flush_flag = 1;
+        branch_target = record->branch_dest;
+    }
+    TRACE("Execute Stage (replay): Opcode %d, Taken = %d\n", stage->decoded.opcode, record->taken);
+    return 0;
+}
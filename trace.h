@@ -0,0 +1,34 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pipelineRun.h"
+
+// One committed instruction of a recorded run
+typedef struct {
+    uint32_t pc;          // Address of the instruction
+    uint32_t instruction; // Encoded instruction (decoded again by ID during replay)
+    uint32_t mem_address; // Effective MOVR/MOVM address, 0 for other opcodes
+    uint32_t branch_dest; // Next PC when the JEQ/JMP was taken
+    uint8_t taken;        // 1 if the instruction redirected the PC
+} TraceRecord;
+
+// Replay state consulted by pipeline_cycle()
+extern bool replay_active;
+extern TraceRecord *trace_records;
+extern uint32_t trace_length;
+extern uint32_t replay_cursor; // Next record to fetch
+
+// Run the loaded program functionally and write its committed instruction stream to `path`.
+// Returns 0 on success, -1 on failure.
+int record_trace(const char *path);
+
+// Load a recorded stream and switch the pipeline into timing-only replay.
+// Returns 0 on success, -1 on failure.
+int load_trace(const char *path);
+
+// Replay stand-in for execute(): raise the recorded branch outcome, no semantics
+uint32_t replay_execute(const PipelineStage *stage);
+
+#endif // TRACE_H
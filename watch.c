@@ -0,0 +1,76 @@
+// watch.c
+// Register/memory watchpoints and PC breakpoints over the hook API
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "registers.h"
+#include "memory.h"
+#include "hooks.h"
+#include "watch.h"
+
+bool watch_stop_requested = false;
+
+static uint32_t watched_registers = 0;
+static uint64_t watched_memory[(MEMORY_SIZE + 63) / 64];
+static uint64_t breakpoints[(MAX_INSTRUCTIONS + 63) / 64];
+static bool registered[HOOK_EVENT_COUNT];
+
+static bool bit_set(const uint64_t *bitmap, uint32_t index) {
+    return (bitmap[index / 64] >> (index % 64)) & 1;
+}
+
+static void on_register_write(const HookInfo *info, void *user) {
+    (void)user;
+    if (!((watched_registers >> info->location) & 1)) return;
+    printf("[WATCH] PC %u: R%u %d -> %d\n", info->pc, info->location, (int32_t)info->old_value, (int32_t)info->value);
+}
+
+static void on_memory_access(const HookInfo *info, void *user) {
+    (void)user;
+    if (info->location >= MEMORY_SIZE || !bit_set(watched_memory, info->location)) return;
+    if (info->is_store) {
+        printf("[WATCH] PC %u: MOVM memory[%u] %d -> %d\n", info->pc, info->location, (int32_t)info->old_value,
+               (int32_t)info->value);
+    } else {
+        printf("[WATCH] PC %u: MOVR memory[%u] read %d\n", info->pc, info->location, (int32_t)info->value);
+    }
+}
+
+static void on_retire(const HookInfo *info, void *user) {
+    (void)user;
+    if (info->pc >= MAX_INSTRUCTIONS || !bit_set(breakpoints, info->pc)) return;
+    printf("[BREAK] Breakpoint at PC %u (instruction 0x%08X)\n", info->pc, info->instruction);
+    watch_stop_requested = true;
+}
+
+// The hook is registered with the first watchpoint of its kind
+static int ensure_hook(HookEvent event, HookFn fn) {
+    if (registered[event]) return 0;
+    if (register_hook(event, fn, NULL) != 0) {
+        fprintf(stderr, "Watchpoints need a build with instrumentation hooks\n");
+        return -1;
+    }
+    registered[event] = true;
+    return 0;
+}
+
+int watch_register(int reg) {
+    if (reg < 0 || reg >= NUM_REGISTERS) return -1;
+    if (ensure_hook(HOOK_REGISTER_WRITE, on_register_write) != 0) return -1;
+    watched_registers |= 1u << reg;
+    return 0;
+}
+
+int watch_memory(uint32_t address) {
+    if (address >= MEMORY_SIZE) return -1;
+    if (ensure_hook(HOOK_MEMORY_ACCESS, on_memory_access) != 0) return -1;
+    watched_memory[address / 64] |= 1ull << (address % 64);
+    return 0;
+}
+
+int break_at_pc(uint32_t pc) {
+    if (pc >= MAX_INSTRUCTIONS) return -1;
+    if (ensure_hook(HOOK_RETIRE, on_retire) != 0) return -1;
+    breakpoints[pc / 64] |= 1ull << (pc % 64);
+    return 0;
+}
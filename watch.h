@@ -0,0 +1,25 @@
+#ifndef WATCH_H
+#define WATCH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Watchpoints and breakpoints built on the instrumentation hooks. Watched
+// registers, memory addresses and breakpoint PCs are each kept as a bitmap, so
+// a hook costs one bit test no matter how many are set.
+//
+// A register watchpoint prints every write to the register, a memory watchpoint
+// every MOVR/MOVM to the address, both with the old and new value. A breakpoint
+// fires when the instruction at its PC retires, so wrong-path fetches never
+// trigger it; the run then stops after the current cycle and prints its usual
+// final state.
+
+// Set by a breakpoint; the simulation loops stop once it is true
+extern bool watch_stop_requested;
+
+// Each returns 0 on success, -1 for an out-of-range argument or a build without hooks
+int watch_register(int reg);
+int watch_memory(uint32_t address);
+int break_at_pc(uint32_t pc);
+
+#endif // WATCH_H